@@ -26,6 +26,7 @@
 
 #include "StudioModelRenderer.h"
 #include "GameStudioModelRenderer.h"
+#include "StudioPoseJobs.h"
 #include "Exports.h"
 
 //
@@ -83,6 +84,55 @@ R_StudioInit
 void R_StudioInit( void )
 {
 	g_StudioRenderer.Init();
+	g_StudioPoseJobs.Init( &g_StudioRenderer );
+}
+
+/*
+====================
+R_StudioVidInit
+
+Models of the previous level are gone, so is their animation data
+====================
+*/
+void R_StudioVidInit( void )
+{
+	g_StudioPoseJobs.Finish();
+	g_StudioRenderer.m_AnimCache.Clear();
+}
+
+/*
+====================
+R_StudioAddEntity
+
+Entity passed HUD_AddEntity, its pose can be set up ahead of drawing
+====================
+*/
+void R_StudioAddEntity( cl_entity_t *ent )
+{
+	g_StudioPoseJobs.AddEntity( ent );
+}
+
+/*
+====================
+R_StudioCreateEntities
+
+Visible list is complete, start the pose workers
+====================
+*/
+void R_StudioCreateEntities( void )
+{
+	g_StudioPoseJobs.Dispatch();
+}
+
+/*
+====================
+R_StudioShutdown
+
+====================
+*/
+void R_StudioShutdown( void )
+{
+	g_StudioPoseJobs.Shutdown();
 }
 
 // The simple drawing interface we'll pass back to the engine
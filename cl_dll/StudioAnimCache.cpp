@@ -0,0 +1,135 @@
+#include "hud.h"
+#include "cl_util.h"
+#include "const.h"
+#include "com_model.h"
+#include "studio.h"
+
+#include "StudioAnimCache.h"
+
+/*
+====================
+StudioDecodeAnimValue
+
+Finds the values of the frame in a RLE stream, following the same rules
+( and quirks ) as StudioCalcBoneQuaterion and StudioCalcBonePosition
+====================
+*/
+void StudioDecodeAnimValue( mstudioanimvalue_t *panimvalue, int frame, short *value1, short *value2, byte *interpolatePosition )
+{
+	int k = frame;
+
+	// DEBUG
+	if (panimvalue->num.total < panimvalue->num.valid)
+		k = 0;
+	// find span of values that includes the frame we want
+	while (panimvalue->num.total <= k)
+	{
+		k -= panimvalue->num.total;
+		panimvalue += panimvalue->num.valid + 1;
+		// DEBUG
+		if (panimvalue->num.total < panimvalue->num.valid)
+			k = 0;
+	}
+
+	// if we're inside the span
+	if (panimvalue->num.valid > k)
+	{
+		*value1 = panimvalue[k+1].value;
+
+		// and there's more data in the span
+		if (panimvalue->num.valid > k + 1)
+		{
+			*value2 = panimvalue[k+2].value;
+			*interpolatePosition = 1;
+		}
+		else
+		{
+			if (panimvalue->num.total > k + 1)
+				*value2 = *value1;
+			else
+				*value2 = panimvalue[panimvalue->num.valid+2].value;
+			*interpolatePosition = 0;
+		}
+	}
+	else
+	{
+		*value1 = panimvalue[panimvalue->num.valid].value;
+
+		// are we at the end of the repeating values section and there's another section with data?
+		if (panimvalue->num.total > k + 1)
+		{
+			*value2 = *value1;
+			*interpolatePosition = 0;
+		}
+		else
+		{
+			*value2 = panimvalue[panimvalue->num.valid + 2].value;
+			*interpolatePosition = 1;
+		}
+	}
+}
+
+/*
+====================
+GetDecodedAnim
+
+====================
+*/
+const CStudioDecodedAnim *CStudioAnimCache::GetDecodedAnim( studiohdr_t *pstudiohdr, mstudioseqdesc_t *pseqdesc, mstudioanim_t *panim )
+{
+	if ( pseqdesc->seqgroup != 0 )
+		return NULL;
+
+	std::lock_guard<std::mutex> lock( m_Mutex );
+
+	auto cached = m_DecodedAnims.find( panim );
+	if ( cached != m_DecodedAnims.end() )
+		return cached->second.get();
+
+	std::unique_ptr<CStudioDecodedAnim> decoded( new CStudioDecodedAnim );
+
+	int numframes = max( pseqdesc->numframes, 1 );
+	int numchannels = pstudiohdr->numbones * 6;
+
+	decoded->m_nNumFrames = numframes;
+	decoded->m_rgChannelStart.resize( numchannels, -1 );
+
+	for ( int channel = 0; channel < numchannels; channel++ )
+	{
+		mstudioanim_t *pboneanim = panim + channel / 6;
+		int j = channel % 6;
+
+		if ( pboneanim->offset[j] == 0 )
+			continue;
+
+		mstudioanimvalue_t *panimvalue = (mstudioanimvalue_t *)((byte *)pboneanim + pboneanim->offset[j]);
+		int start = decoded->m_rgValue1.size();
+
+		decoded->m_rgChannelStart[channel] = start;
+		decoded->m_rgValue1.resize( start + numframes );
+		decoded->m_rgValue2.resize( start + numframes );
+		decoded->m_rgInterpolatePosition.resize( start + numframes );
+
+		for ( int frame = 0; frame < numframes; frame++ )
+		{
+			StudioDecodeAnimValue( panimvalue, frame, &decoded->m_rgValue1[start + frame], &decoded->m_rgValue2[start + frame], &decoded->m_rgInterpolatePosition[start + frame] );
+		}
+	}
+
+	const CStudioDecodedAnim *result = decoded.get();
+	m_DecodedAnims[panim] = std::move( decoded );
+
+	return result;
+}
+
+/*
+====================
+Clear
+
+====================
+*/
+void CStudioAnimCache::Clear( void )
+{
+	std::lock_guard<std::mutex> lock( m_Mutex );
+	m_DecodedAnims.clear();
+}
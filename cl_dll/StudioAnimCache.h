@@ -0,0 +1,59 @@
+#if !defined ( STUDIOANIMCACHE_H )
+#define STUDIOANIMCACHE_H
+#if defined( _WIN32 )
+#pragma once
+#endif
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/*
+====================
+CStudioDecodedAnim
+
+Keyframes of one blend of a sequence, expanded from the RLE compressed
+mstudioanimvalue_t streams. Values are stored per channel ( bone * 6 + X, Y, Z, XR, YR, ZR )
+in separate arrays, so a frame lookup is a single index.
+====================
+*/
+class CStudioDecodedAnim
+{
+public:
+	int					m_nNumFrames;
+
+	// Start of the channel in the value arrays, -1 when channel uses the bone default
+	std::vector<int>	m_rgChannelStart;
+
+	// Value at the frame and the value to interpolate towards
+	std::vector<short>	m_rgValue1;
+	std::vector<short>	m_rgValue2;
+
+	// Positions only interpolate inside a run of valid values
+	std::vector<byte>	m_rgInterpolatePosition;
+};
+
+/*
+====================
+CStudioAnimCache
+
+Decodes animations on first use. Only sequences from the main model file ( seqgroup 0 )
+are cached, because demand loaded sequence groups can be purged and moved by the engine.
+Must be cleared whenever models can be unloaded.
+====================
+*/
+class CStudioAnimCache
+{
+public:
+	const CStudioDecodedAnim *GetDecodedAnim( studiohdr_t *pstudiohdr, mstudioseqdesc_t *pseqdesc, mstudioanim_t *panim );
+	void Clear( void );
+
+private:
+	std::mutex m_Mutex;
+	std::unordered_map<const mstudioanim_t *, std::unique_ptr<CStudioDecodedAnim>> m_DecodedAnims;
+};
+
+void StudioDecodeAnimValue( mstudioanimvalue_t *panimvalue, int frame, short *value1, short *value2, byte *interpolatePosition );
+
+#endif // STUDIOANIMCACHE_H
@@ -21,6 +21,7 @@
 
 #include "StudioModelRenderer.h"
 #include "GameStudioModelRenderer.h"
+#include "StudioPoseJobs.h"
 #include "cpp_aux.h"
 
 extern cvar_t *tfc_newmodels;
@@ -53,6 +54,7 @@ void CStudioModelRenderer::Init( void )
 	m_pCvarHiModels			= IEngineStudio.GetCvar( "cl_himodels" );
 	m_pCvarDeveloper		= IEngineStudio.GetCvar( "developer" );
 	m_pCvarDrawEntities		= IEngineStudio.GetCvar( "r_drawentities" );
+	m_pCvarAnimCache		= CVAR_CREATE( "r_studio_animcache", "1", FCVAR_ARCHIVE );
 
 	m_pChromeSprite			= IEngineStudio.GetChromeSprite();
 
@@ -79,6 +81,8 @@ CStudioModelRenderer::CStudioModelRenderer( void )
 	m_pCvarHiModels		= NULL;
 	m_pCvarDeveloper	= NULL;
 	m_pCvarDrawEntities	= NULL;
+	m_pCvarAnimCache	= NULL;
+	m_pAnimCache		= &m_AnimCache;
 	m_pChromeSprite		= NULL;
 	m_pStudioModelCount	= NULL;
 	m_pModelsDrawn		= NULL;
@@ -324,6 +328,92 @@ void CStudioModelRenderer::StudioCalcBonePosition( int frame, float s, mstudiobo
 	}
 }
 
+/*
+====================
+StudioCalcCachedBoneQuaterion
+
+Same as StudioCalcBoneQuaterion, with values taken from decoded animation
+====================
+*/
+void CStudioModelRenderer::StudioCalcCachedBoneQuaterion( int frame, float s, mstudiobone_t *pbone, const CStudioDecodedAnim *pdecoded, int bone, float *adj, float *q )
+{
+	int					j, index;
+	vec4_t				q1, q2;
+	vec3_t				angle1, angle2;
+
+	for (j = 0; j < 3; j++)
+	{
+		index = pdecoded->m_rgChannelStart[bone * 6 + j + 3];
+		if (index == -1)
+		{
+			angle2[j] = angle1[j] = pbone->value[j+3]; // default;
+		}
+		else
+		{
+			angle1[j] = pdecoded->m_rgValue1[index + frame];
+			angle2[j] = pdecoded->m_rgValue2[index + frame];
+
+			angle1[j] = pbone->value[j+3] + angle1[j] * pbone->scale[j+3];
+			angle2[j] = pbone->value[j+3] + angle2[j] * pbone->scale[j+3];
+		}
+
+		if (pbone->bonecontroller[j+3] != -1)
+		{
+			angle1[j] += adj[pbone->bonecontroller[j+3]];
+			angle2[j] += adj[pbone->bonecontroller[j+3]];
+		}
+	}
+
+	if (!VectorCompare( angle1, angle2 ))
+	{
+		AngleQuaternion( angle1, q1 );
+		AngleQuaternion( angle2, q2 );
+		QuaternionSlerp( q1, q2, s, q );
+	}
+	else
+	{
+		AngleQuaternion( angle1, q );
+	}
+}
+
+/*
+====================
+StudioCalcCachedBonePosition
+
+Same as StudioCalcBonePosition, with values taken from decoded animation
+====================
+*/
+void CStudioModelRenderer::StudioCalcCachedBonePosition( int frame, float s, mstudiobone_t *pbone, const CStudioDecodedAnim *pdecoded, int bone, float *adj, float *pos )
+{
+	int					j, index;
+	short				value1, value2;
+
+	for (j = 0; j < 3; j++)
+	{
+		pos[j] = pbone->value[j]; // default;
+
+		index = pdecoded->m_rgChannelStart[bone * 6 + j];
+		if (index != -1)
+		{
+			value1 = pdecoded->m_rgValue1[index + frame];
+			value2 = pdecoded->m_rgValue2[index + frame];
+
+			if (pdecoded->m_rgInterpolatePosition[index + frame])
+			{
+				pos[j] += (value1 * (1.0 - s) + s * value2) * pbone->scale[j];
+			}
+			else
+			{
+				pos[j] += value1 * pbone->scale[j];
+			}
+		}
+		if ( pbone->bonecontroller[j] != -1 && adj )
+		{
+			pos[j] += adj[pbone->bonecontroller[j]];
+		}
+	}
+}
+
 /*
 ====================
 StudioSlerpBones
@@ -595,6 +685,7 @@ void CStudioModelRenderer::StudioCalcRotations ( float pos[][3], vec4_t *q, mstu
 	float				s;
 	float				adj[MAXSTUDIOCONTROLLERS];
 	float				dadt;
+	const CStudioDecodedAnim *pdecoded = NULL;
 
 	if (f > pseqdesc->numframes - 1)
 	{
@@ -625,13 +716,30 @@ void CStudioModelRenderer::StudioCalcRotations ( float pos[][3], vec4_t *q, mstu
 
 	StudioCalcBoneAdj( dadt, adj, m_pCurrentEntity->curstate.controller, m_pCurrentEntity->latched.prevcontroller, m_pCurrentEntity->mouth.mouthopen );
 
-	for (i = 0; i < m_pStudioHeader->numbones; i++, pbone++, panim++) 
+	if ( m_pCvarAnimCache && m_pCvarAnimCache->value )
 	{
-		StudioCalcBoneQuaterion( frame, s, pbone, panim, adj, q[i] );
+		pdecoded = m_pAnimCache->GetDecodedAnim( m_pStudioHeader, pseqdesc, panim );
+	}
+
+	if ( pdecoded )
+	{
+		for (i = 0; i < m_pStudioHeader->numbones; i++, pbone++) 
+		{
+			StudioCalcCachedBoneQuaterion( frame, s, pbone, pdecoded, i, adj, q[i] );
 
-		StudioCalcBonePosition( frame, s, pbone, panim, adj, pos[i] );
-		// if (0 && i == 0)
-		//	Con_DPrintf("%d %d %d %d\n", m_pCurrentEntity->curstate.sequence, frame, j, k );
+			StudioCalcCachedBonePosition( frame, s, pbone, pdecoded, i, adj, pos[i] );
+		}
+	}
+	else
+	{
+		for (i = 0; i < m_pStudioHeader->numbones; i++, pbone++, panim++) 
+		{
+			StudioCalcBoneQuaterion( frame, s, pbone, panim, adj, q[i] );
+
+			StudioCalcBonePosition( frame, s, pbone, panim, adj, pos[i] );
+			// if (0 && i == 0)
+			//	Con_DPrintf("%d %d %d %d\n", m_pCurrentEntity->curstate.sequence, frame, j, k );
+		}
 	}
 
 	if (pseqdesc->motiontype & STUDIO_X)
@@ -773,11 +881,13 @@ float CStudioModelRenderer::StudioEstimateFrame( mstudioseqdesc_t *pseqdesc )
 
 /*
 ====================
-StudioSetupBones
+StudioCalcPose
 
+Local bone positions and rotations of the current entity, before any matrices are built.
+Scratch buffers live on the stack, so this can run on pose worker threads.
 ====================
 */
-void CStudioModelRenderer::StudioSetupBones ( void )
+void CStudioModelRenderer::StudioCalcPose ( float pos[][3], vec4_t *q )
 {
 	int					i;
 	double				f;
@@ -786,16 +896,12 @@ void CStudioModelRenderer::StudioSetupBones ( void )
 	mstudioseqdesc_t	*pseqdesc;
 	mstudioanim_t		*panim;
 
-	static float		pos[MAXSTUDIOBONES][3];
-	static vec4_t		q[MAXSTUDIOBONES];
-	float				bonematrix[3][4];
-
-	static float		pos2[MAXSTUDIOBONES][3];
-	static vec4_t		q2[MAXSTUDIOBONES];
-	static float		pos3[MAXSTUDIOBONES][3];
-	static vec4_t		q3[MAXSTUDIOBONES];
-	static float		pos4[MAXSTUDIOBONES][3];
-	static vec4_t		q4[MAXSTUDIOBONES];
+	float				pos2[MAXSTUDIOBONES][3];
+	vec4_t				q2[MAXSTUDIOBONES];
+	float				pos3[MAXSTUDIOBONES][3];
+	vec4_t				q3[MAXSTUDIOBONES];
+	float				pos4[MAXSTUDIOBONES][3];
+	vec4_t				q4[MAXSTUDIOBONES];
 
 	if (m_pCurrentEntity->curstate.sequence >=  m_pStudioHeader->numseq) 
 	{
@@ -865,8 +971,8 @@ void CStudioModelRenderer::StudioSetupBones ( void )
 		( m_pCurrentEntity->latched.prevsequence < m_pStudioHeader->numseq ))
 	{
 		// blend from last sequence
-		static float		pos1b[MAXSTUDIOBONES][3];
-		static vec4_t		q1b[MAXSTUDIOBONES];
+		float				pos1b[MAXSTUDIOBONES][3];
+		vec4_t				q1b[MAXSTUDIOBONES];
 		float				s;
 
 		if (m_pCurrentEntity->latched.prevsequence >=  m_pStudioHeader->numseq) 
@@ -956,6 +1062,31 @@ void CStudioModelRenderer::StudioSetupBones ( void )
 			}
 		}
 	}
+}
+
+/*
+====================
+StudioSetupBones
+
+====================
+*/
+void CStudioModelRenderer::StudioSetupBones ( void )
+{
+	int					i;
+
+	mstudiobone_t		*pbones;
+
+	static float		pos[MAXSTUDIOBONES][3];
+	static vec4_t		q[MAXSTUDIOBONES];
+	float				bonematrix[3][4];
+
+	// Pose may already have been computed ahead of time by a worker thread
+	if ( m_pPlayerInfo || !g_StudioPoseJobs.TakePose( this, pos, q ) )
+	{
+		StudioCalcPose( pos, q );
+	}
+
+	pbones = (mstudiobone_t *)((byte *)m_pStudioHeader + m_pStudioHeader->boneindex);
 
 	for (i = 0; i < m_pStudioHeader->numbones; i++) 
 	{
@@ -11,6 +11,8 @@
 #pragma once
 #endif
 
+#include "StudioAnimCache.h"
+
 /*
 ====================
 CStudioModelRenderer
@@ -45,6 +47,9 @@ public:
 	// Set up model bone positions
 	virtual void StudioSetupBones ( void );	
 
+	// Compute local bone positions and rotations for current entity
+	virtual void StudioCalcPose ( float pos[][3], vec4_t *q );
+
 	// Find final attachment points
 	virtual void StudioCalcAttachments ( void );
 	
@@ -75,6 +80,10 @@ public:
 	// Get bone positions
 	virtual void StudioCalcBonePosition ( int frame, float s, mstudiobone_t *pbone, mstudioanim_t *panim, float *adj, float *pos );
 
+	// Get bone quaternions and positions from decoded animation
+	virtual void StudioCalcCachedBoneQuaterion ( int frame, float s, mstudiobone_t *pbone, const CStudioDecodedAnim *pdecoded, int bone, float *adj, float *q );
+	virtual void StudioCalcCachedBonePosition ( int frame, float s, mstudiobone_t *pbone, const CStudioDecodedAnim *pdecoded, int bone, float *adj, float *pos );
+
 	// Compute rotations
 	virtual void StudioCalcRotations ( float pos[][3], vec4_t *q, mstudioseqdesc_t *pseqdesc, mstudioanim_t *panim, float f );
 
@@ -121,6 +130,8 @@ public:
 	cvar_t			*m_pCvarDeveloper;
 	// Draw entities bone hit boxes, etc?
 	cvar_t			*m_pCvarDrawEntities;
+	// Use decoded animation cache?
+	cvar_t			*m_pCvarAnimCache;
 
 	// The entity which we are currently rendering.
 	cl_entity_t		*m_pCurrentEntity;		
@@ -161,6 +172,10 @@ public:
 	float			m_rgCachedBoneTransform [ MAXSTUDIOBONES ][ 3 ][ 4 ];
 	float			m_rgCachedLightTransform[ MAXSTUDIOBONES ][ 3 ][ 4 ];
 
+	// Decoded animation keyframes, pose workers share the cache of the main renderer
+	CStudioAnimCache m_AnimCache;
+	CStudioAnimCache *m_pAnimCache;
+
 	// Software renderer scale factors
 	float			m_fSoftwareXScale, m_fSoftwareYScale;
 
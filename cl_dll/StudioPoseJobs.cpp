@@ -0,0 +1,390 @@
+// StudioPoseJobs.cpp
+// computes local bone poses of studio entities on worker threads
+
+#include "hud.h"
+#include "cl_util.h"
+#include "const.h"
+#include "com_model.h"
+#include "studio.h"
+#include "entity_state.h"
+#include "cl_entity.h"
+
+#include <string.h>
+#include <memory.h>
+
+#include "r_studioint.h"
+
+#include "StudioModelRenderer.h"
+#include "StudioPoseJobs.h"
+
+extern engine_studio_api_t IEngineStudio;
+
+// Workers beyond this don't pay off, there are rarely enough animated entities in view
+#define MAX_POSE_WORKERS	3
+
+CStudioPoseJobs g_StudioPoseJobs;
+
+/*
+====================
+CStudioPoseJobs
+
+====================
+*/
+CStudioPoseJobs::CStudioPoseJobs( void )
+{
+	m_pCvarThreads	= NULL;
+	m_pCvarVerify	= NULL;
+	m_nNumJobs		= 0;
+	m_fDispatched	= false;
+	m_nNextJob		= 0;
+	m_nGeneration	= 0;
+	m_fJobsOpen		= false;
+	m_nBusyWorkers	= 0;
+	m_fShutdown		= false;
+}
+
+/*
+====================
+Init
+
+====================
+*/
+void CStudioPoseJobs::Init( CStudioModelRenderer *prenderer )
+{
+	m_pCvarThreads	= CVAR_CREATE( "r_studio_threads", "1", FCVAR_ARCHIVE );
+	m_pCvarVerify	= CVAR_CREATE( "r_studio_threads_verify", "0", 0 );
+
+	if ( !m_Workers.empty() )
+		return;
+
+	int numWorkers = (int)std::thread::hardware_concurrency() - 1;
+	if ( numWorkers > MAX_POSE_WORKERS )
+		numWorkers = MAX_POSE_WORKERS;
+
+	m_pLocalRenderer.reset( new CStudioModelRenderer() );
+	m_pLocalRenderer->m_pCvarAnimCache = prenderer->m_pCvarAnimCache;
+	m_pLocalRenderer->m_pAnimCache = prenderer->m_pAnimCache;
+
+	for ( int i = 0; i < numWorkers; i++ )
+	{
+		CStudioModelRenderer *pworker = new CStudioModelRenderer();
+		pworker->m_pCvarAnimCache = prenderer->m_pCvarAnimCache;
+		pworker->m_pAnimCache = prenderer->m_pAnimCache;
+
+		m_WorkerRenderers.emplace_back( pworker );
+	}
+
+	for ( int i = 0; i < numWorkers; i++ )
+	{
+		m_Workers.emplace_back( &CStudioPoseJobs::WorkerThread, this, i );
+	}
+}
+
+/*
+====================
+Shutdown
+
+Threads have to be gone before the DLL is unloaded
+====================
+*/
+void CStudioPoseJobs::Shutdown( void )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_fShutdown = true;
+		m_nNextJob = m_nNumJobs;
+	}
+	m_WakeUp.notify_all();
+
+	for ( size_t i = 0; i < m_Workers.size(); i++ )
+	{
+		m_Workers[i].join();
+	}
+
+	m_Workers.clear();
+	m_WorkerRenderers.clear();
+	m_nNumJobs = 0;
+}
+
+/*
+====================
+AddEntity
+
+Players and entities following another model depend on state that only exists at draw time
+====================
+*/
+void CStudioPoseJobs::AddEntity( cl_entity_t *ent )
+{
+	if ( m_fDispatched )
+	{
+		Finish();
+		m_Entities.clear();
+		m_fDispatched = false;
+	}
+
+	if ( !m_pCvarThreads || !m_pCvarThreads->value || m_Workers.empty() )
+		return;
+
+	if ( !ent->model || ent->model->type != mod_studio || ent->player )
+		return;
+
+	if ( ent->curstate.movetype == MOVETYPE_FOLLOW || ent->curstate.renderfx == kRenderFxDeadPlayer )
+		return;
+
+	m_Entities.push_back( ent );
+}
+
+/*
+====================
+Dispatch
+
+====================
+*/
+void CStudioPoseJobs::Dispatch( void )
+{
+	int		framecount;
+	double	clTime, clOldTime;
+	int		numJobs = 0;
+
+	// Nothing was added this frame, the previous jobs may still be running
+	if ( m_fDispatched )
+	{
+		Finish();
+		m_Entities.clear();
+	}
+
+	m_fDispatched = true;
+
+	if ( m_Entities.empty() )
+		return;
+
+	IEngineStudio.GetTimes( &framecount, &clTime, &clOldTime );
+
+	for ( size_t i = 0; i < m_Entities.size(); i++ )
+	{
+		cl_entity_t *ent = m_Entities[i];
+		if ( ent->index < 0 )
+			continue;
+
+		studiohdr_t *phdr = (studiohdr_t *)IEngineStudio.Mod_Extradata( ent->model );
+		if ( !phdr || phdr->numbones > MAXSTUDIOBONES || phdr->numseq <= 0 )
+			continue;
+
+		// Demand loaded sequence groups go through the engine's cache, which is not thread safe
+		mstudioseqdesc_t *pseqdesc = (mstudioseqdesc_t *)( (byte *)phdr + phdr->seqindex );
+
+		int sequence = ent->curstate.sequence >= phdr->numseq ? 0 : ent->curstate.sequence;
+		if ( sequence < 0 || pseqdesc[sequence].seqgroup != 0 )
+			continue;
+
+		int prevsequence = ent->latched.prevsequence;
+		if ( prevsequence < 0 || ( prevsequence < phdr->numseq && pseqdesc[prevsequence].seqgroup != 0 ) )
+			continue;
+
+		if ( numJobs == (int)m_Jobs.size() )
+			m_Jobs.emplace_back( new CStudioPoseJob() );
+
+		if ( ent->index >= (int)m_JobIndex.size() )
+			m_JobIndex.resize( ent->index + 1, -1 );
+		m_JobIndex[ent->index] = numJobs;
+
+		CStudioPoseJob *pjob = m_Jobs[numJobs++].get();
+
+		pjob->m_pEntity			= ent;
+		pjob->m_pStudioHeader	= phdr;
+		pjob->m_clTime			= clTime;
+		pjob->m_curstate		= ent->curstate;
+		pjob->m_latched			= ent->latched;
+		pjob->m_mouth			= ent->mouth;
+		pjob->m_entity			= *ent;
+		pjob->m_nState			= CStudioPoseJob::JOB_PENDING;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_nNumJobs = numJobs;
+		m_nNextJob = 0;
+		m_nGeneration++;
+		m_fJobsOpen = true;
+	}
+	m_WakeUp.notify_all();
+}
+
+/*
+====================
+Finish
+
+A worker that wakes up late sees the generation closed and goes back to sleep,
+so nothing touches the jobs again until the next Dispatch
+====================
+*/
+void CStudioPoseJobs::Finish( void )
+{
+	{
+		std::unique_lock<std::mutex> lock( m_Mutex );
+		m_fJobsOpen = false;
+		m_nNextJob = m_nNumJobs;
+
+		m_WorkersDone.wait( lock, [&] { return m_nBusyWorkers == 0; } );
+	}
+
+	for ( int i = 0; i < m_nNumJobs; i++ )
+	{
+		m_JobIndex[m_Jobs[i]->m_pEntity->index] = -1;
+	}
+
+	std::lock_guard<std::mutex> lock( m_Mutex );
+	m_nNumJobs = 0;
+}
+
+/*
+====================
+WorkerThread
+
+====================
+*/
+void CStudioPoseJobs::WorkerThread( int worker )
+{
+	CStudioModelRenderer *prenderer = m_WorkerRenderers[worker].get();
+	int generation = 0;
+
+	while ( true )
+	{
+		int numJobs;
+
+		{
+			std::unique_lock<std::mutex> lock( m_Mutex );
+			m_WakeUp.wait( lock, [&] { return m_fShutdown || ( m_fJobsOpen && m_nGeneration != generation ); } );
+
+			if ( m_fShutdown )
+				return;
+
+			generation = m_nGeneration;
+			numJobs = m_nNumJobs;
+			m_nBusyWorkers++;
+		}
+
+		int i;
+		while ( m_nNextJob < numJobs && ( i = m_nNextJob++ ) < numJobs )
+		{
+			CStudioPoseJob *pjob = m_Jobs[i].get();
+
+			int expected = CStudioPoseJob::JOB_PENDING;
+			if ( pjob->m_nState.compare_exchange_strong( expected, CStudioPoseJob::JOB_RUNNING ) )
+			{
+				RunJob( pjob, prenderer );
+				pjob->m_nState = CStudioPoseJob::JOB_DONE;
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( m_Mutex );
+			m_nBusyWorkers--;
+		}
+		m_WorkersDone.notify_all();
+	}
+}
+
+/*
+====================
+RunJob
+
+====================
+*/
+void CStudioPoseJobs::RunJob( CStudioPoseJob *pjob, CStudioModelRenderer *prenderer )
+{
+	prenderer->m_pCurrentEntity	= &pjob->m_entity;
+	prenderer->m_pRenderModel	= pjob->m_entity.model;
+	prenderer->m_pStudioHeader	= pjob->m_pStudioHeader;
+	prenderer->m_pPlayerInfo	= NULL;
+	prenderer->m_clTime			= pjob->m_clTime;
+	prenderer->m_fDoInterp		= 1;
+
+	prenderer->StudioCalcPose( pjob->m_pos, pjob->m_q );
+}
+
+/*
+====================
+IsJobValid
+
+Pose is only usable when serial setup would start from exactly the same input
+====================
+*/
+bool CStudioPoseJobs::IsJobValid( CStudioPoseJob *pjob, CStudioModelRenderer *prenderer )
+{
+	cl_entity_t *ent = prenderer->m_pCurrentEntity;
+
+	if ( pjob->m_pStudioHeader != prenderer->m_pStudioHeader || pjob->m_clTime != prenderer->m_clTime || !prenderer->m_fDoInterp )
+		return false;
+
+	return	!memcmp( &pjob->m_curstate, &ent->curstate, sizeof( entity_state_t ) ) &&
+			!memcmp( &pjob->m_latched, &ent->latched, sizeof( latchedvars_t ) ) &&
+			!memcmp( &pjob->m_mouth, &ent->mouth, sizeof( mouth_t ) );
+}
+
+/*
+====================
+TakePose
+
+====================
+*/
+bool CStudioPoseJobs::TakePose( CStudioModelRenderer *prenderer, float pos[][3], vec4_t *q )
+{
+	cl_entity_t *ent = prenderer->m_pCurrentEntity;
+
+	if ( ent->index < 0 || ent->index >= (int)m_JobIndex.size() )
+		return false;
+
+	int job = m_JobIndex[ent->index];
+	if ( job < 0 || job >= m_nNumJobs || m_Jobs[job]->m_pEntity != ent )
+		return false;
+
+	CStudioPoseJob *pjob = m_Jobs[job].get();
+	if ( !IsJobValid( pjob, prenderer ) )
+		return false;
+
+	// Nobody got to it yet, run it here
+	int expected = CStudioPoseJob::JOB_PENDING;
+	if ( pjob->m_nState.compare_exchange_strong( expected, CStudioPoseJob::JOB_RUNNING ) )
+	{
+		RunJob( pjob, m_pLocalRenderer.get() );
+		pjob->m_nState = CStudioPoseJob::JOB_DONE;
+	}
+
+	while ( pjob->m_nState == CStudioPoseJob::JOB_RUNNING )
+	{
+		std::this_thread::yield();
+	}
+
+	// Second draw of the same entity this frame starts from updated state
+	expected = CStudioPoseJob::JOB_DONE;
+	if ( !pjob->m_nState.compare_exchange_strong( expected, CStudioPoseJob::JOB_TAKEN ) )
+		return false;
+
+	int numbones = pjob->m_pStudioHeader->numbones;
+
+	if ( m_pCvarVerify && m_pCvarVerify->value )
+	{
+		static float	verifypos[MAXSTUDIOBONES][3];
+		static vec4_t	verifyq[MAXSTUDIOBONES];
+
+		prenderer->StudioCalcPose( verifypos, verifyq );
+
+		if ( memcmp( verifypos, pjob->m_pos, numbones * sizeof( verifypos[0] ) ) ||
+			memcmp( verifyq, pjob->m_q, numbones * sizeof( verifyq[0] ) ) ||
+			memcmp( &ent->curstate, &pjob->m_entity.curstate, sizeof( entity_state_t ) ) ||
+			memcmp( &ent->latched, &pjob->m_entity.latched, sizeof( latchedvars_t ) ) )
+		{
+			gEngfuncs.Con_Printf( "r_studio_threads: pose mismatch for entity %d ( %s )\n", ent->index, ent->model->name );
+		}
+	}
+
+	memcpy( pos, pjob->m_pos, numbones * sizeof( pos[0] ) );
+	memcpy( q, pjob->m_q, numbones * sizeof( q[0] ) );
+
+	// Same side effects as serial setup has on the entity
+	ent->curstate = pjob->m_entity.curstate;
+	ent->latched = pjob->m_entity.latched;
+
+	return true;
+}
@@ -0,0 +1,120 @@
+#if !defined ( STUDIOPOSEJOBS_H )
+#define STUDIOPOSEJOBS_H
+#if defined( _WIN32 )
+#pragma once
+#endif
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class CStudioModelRenderer;
+
+/*
+====================
+CStudioPoseJob
+
+Local pose of one entity computed ahead of drawing. The job works on a copy of the entity,
+the state it was copied from is kept to tell whether the pose is still valid at draw time.
+====================
+*/
+class CStudioPoseJob
+{
+public:
+	enum
+	{
+		JOB_PENDING = 0,
+		JOB_RUNNING,
+		JOB_DONE,
+		JOB_TAKEN,
+	};
+
+	std::atomic<int>	m_nState;
+
+	cl_entity_t			*m_pEntity;
+	studiohdr_t			*m_pStudioHeader;
+	double				m_clTime;
+
+	// Entity state the pose was computed from
+	entity_state_t		m_curstate;
+	latchedvars_t		m_latched;
+	mouth_t				m_mouth;
+
+	// Working copy, holds the side effects of pose setup afterwards
+	cl_entity_t			m_entity;
+
+	float				m_pos[MAXSTUDIOBONES][3];
+	vec4_t				m_q[MAXSTUDIOBONES];
+};
+
+/*
+====================
+CStudioPoseJobs
+
+Computes local bone poses of ordinary studio entities on worker threads between
+HUD_CreateEntities and rendering. The draw thread takes a finished pose when the entity
+is unchanged since the job was queued, otherwise it computes the pose itself, so
+the result is always the same as serial setup.
+====================
+*/
+class CStudioPoseJobs
+{
+public:
+	CStudioPoseJobs( void );
+
+	void Init( CStudioModelRenderer *prenderer );
+	void Shutdown( void );
+
+	// Collect entities while the engine builds the visible list
+	void AddEntity( cl_entity_t *ent );
+
+	// Queue collected entities and wake up the workers
+	void Dispatch( void );
+
+	// Stop handing out jobs and wait for the running ones
+	void Finish( void );
+
+	// Copy the pose computed for the renderer's current entity, false if there is none
+	bool TakePose( CStudioModelRenderer *prenderer, float pos[][3], vec4_t *q );
+
+private:
+	void WorkerThread( int worker );
+	void RunJob( CStudioPoseJob *pjob, CStudioModelRenderer *prenderer );
+	bool IsJobValid( CStudioPoseJob *pjob, CStudioModelRenderer *prenderer );
+
+	// r_studio_threads - 0 disables pose workers
+	cvar_t					*m_pCvarThreads;
+	// r_studio_threads_verify - compare every taken pose against serial setup
+	cvar_t					*m_pCvarVerify;
+
+	std::vector<cl_entity_t *>						m_Entities;
+	std::vector<std::unique_ptr<CStudioPoseJob>>	m_Jobs;
+	int												m_nNumJobs;
+	// Job of each entity index, -1 if none
+	std::vector<int>								m_JobIndex;
+	bool											m_fDispatched;
+
+	std::atomic<int>		m_nNextJob;
+
+	std::vector<std::thread>							m_Workers;
+	std::vector<std::unique_ptr<CStudioModelRenderer>>	m_WorkerRenderers;
+	// Used when the draw thread runs a job nobody picked up yet
+	std::unique_ptr<CStudioModelRenderer>				m_pLocalRenderer;
+
+	// Workers only start on jobs of an open generation and are counted while they run them,
+	// Finish closes the generation and waits for the count to drop to zero
+	std::mutex				m_Mutex;
+	std::condition_variable	m_WakeUp;
+	std::condition_variable	m_WorkersDone;
+	int						m_nGeneration;
+	bool					m_fJobsOpen;
+	int						m_nBusyWorkers;
+	bool					m_fShutdown;
+};
+
+extern CStudioPoseJobs g_StudioPoseJobs;
+
+#endif // STUDIOPOSEJOBS_H
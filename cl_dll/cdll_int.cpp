@@ -36,6 +36,7 @@ extern "C"
 {
 #include "pm_shared.h"
 }
+#include "pm_materials.h"
 
 #include <string.h>
 #include "hud_servers.h"
@@ -214,10 +215,17 @@ so the HUD can reinitialize itself.
 ==========================
 */
 
+extern void R_StudioVidInit( void );
+
 int CL_DLLEXPORT HUD_VidInit( void )
 {
 //	RecClHudVidInit();
 	gHUD.VidInit();
+
+	R_StudioVidInit();
+
+	// Texture names of the previous map are gone
+	PM_ClearMaterialCache();
 
 	VGui_Startup();
 
@@ -1,6 +1,7 @@
 // Client side entity management functions
 
 #include <memory.h>
+#include <vector>
 
 #include "hud.h"
 #include "cl_util.h"
@@ -14,11 +15,14 @@
 #include "pm_shared.h"
 #include "bench.h"
 #include "Exports.h"
+#include "tempent_batch.h"
 
 #include "particleman.h"
 extern IParticleMan *g_pParticleMan;
 
 void Game_AddObjects( void );
+void R_StudioAddEntity( cl_entity_t *ent );
+void R_StudioCreateEntities( void );
 
 extern vec3_t v_origin;
 
@@ -38,6 +42,7 @@ int CL_DLLEXPORT HUD_AddEntity( int type, struct cl_entity_s *ent, const char *m
 	{
 	case ET_NORMAL:
 		Bench_CheckEntity( type, ent, modelname );
+		R_StudioAddEntity( ent );
 		break;
 	case ET_PLAYER:
 	case ET_BEAM:
@@ -318,6 +323,8 @@ void CL_DLLEXPORT HUD_CreateEntities( void )
 	Game_AddObjects();
 
 	GetClientVoiceMgr()->CreateEntities();
+
+	R_StudioCreateEntities();
 }
 
 #if defined( _TFC )
@@ -375,11 +382,172 @@ void CL_DLLEXPORT HUD_StudioEvent( const struct mstudioevent_s *event, const str
 	}
 }
 
+// Per frame working sets of HUD_TempEntUpdate, kept around to avoid reallocating
+static CTempEntBatch g_TempEntBatch;
+static std::vector<TEMPENTITY *> g_rgActiveTemps;
+static std::vector<TEMPENTITY *> g_rgCollideTemps;
+
+/*
+=================
+TempEntSetUpPlayers
+
+In order to have tents collide with players, we have to run the player prediction code so
+that the client has the player list. This is only done once the first COLLIDEALL tent
+of the update is traced, most updates don't have any.
+=================
+*/
+static void TempEntSetUpPlayers( bool *pfPlayersSolid )
+{
+	if ( *pfPlayersSolid )
+		return;
+
+	gEngfuncs.pEventAPI->EV_SetUpPlayerPrediction( false, true );
+
+	// Store off the old count
+	gEngfuncs.pEventAPI->EV_PushPMStates();
+
+	// Now add in all of the players.
+	gEngfuncs.pEventAPI->EV_SetSolidPlayers ( -1 );	
+
+	*pfPlayersSolid = true;
+}
+
+/*
+=================
+TempEntCollide
+
+Trace a tent from its previous origin and bounce it off whatever it hit
+=================
+*/
+static void TempEntCollide( TEMPENTITY *pTemp, double frametime, double client_time, float gravity, bool *pfPlayersSolid, void ( *Callback_TempEntPlaySound )( TEMPENTITY *pTemp, float damp ) )
+{
+	vec3_t	traceNormal;
+	float	traceFraction = 1;
+
+	if ( pTemp->flags & FTENT_COLLIDEALL )
+	{
+		pmtrace_t pmtrace;
+		physent_t *pe;
+
+		TempEntSetUpPlayers( pfPlayersSolid );
+
+		gEngfuncs.pEventAPI->EV_SetTraceHull( 2 );
+
+		gEngfuncs.pEventAPI->EV_PlayerTrace( pTemp->entity.prevstate.origin, pTemp->entity.origin, PM_STUDIO_BOX, -1, &pmtrace );
+
+
+		if ( pmtrace.fraction != 1 )
+		{
+			pe = gEngfuncs.pEventAPI->EV_GetPhysent( pmtrace.ent );
+
+			if ( !pmtrace.ent || ( pe->info != pTemp->clientIndex ) )
+			{
+				traceFraction = pmtrace.fraction;
+				VectorCopy( pmtrace.plane.normal, traceNormal );
+
+				if ( pTemp->hitcallback )
+				{
+					(*pTemp->hitcallback)( pTemp, &pmtrace );
+				}
+			}
+		}
+	}
+	else if ( pTemp->flags & FTENT_COLLIDEWORLD )
+	{
+		pmtrace_t pmtrace;
+		
+		gEngfuncs.pEventAPI->EV_SetTraceHull( 2 );
+
+		gEngfuncs.pEventAPI->EV_PlayerTrace( pTemp->entity.prevstate.origin, pTemp->entity.origin, PM_STUDIO_BOX | PM_WORLD_ONLY, -1, &pmtrace );					
+
+		if ( pmtrace.fraction != 1 )
+		{
+			traceFraction = pmtrace.fraction;
+			VectorCopy( pmtrace.plane.normal, traceNormal );
+
+			if ( pTemp->flags & FTENT_SPARKSHOWER )
+			{
+				// Chop spark speeds a bit more
+				//
+				VectorScale( pTemp->entity.baseline.origin, 0.6, pTemp->entity.baseline.origin );
+
+				if ( Length( pTemp->entity.baseline.origin ) < 10 )
+				{
+					pTemp->entity.baseline.framerate = 0.0;								
+				}
+			}
+
+			if ( pTemp->hitcallback )
+			{
+				(*pTemp->hitcallback)( pTemp, &pmtrace );
+			}
+		}
+	}
+	
+	if ( traceFraction != 1 )	// Decent collision now, and damping works
+	{
+		float  proj, damp;
+
+		// Place at contact point
+		VectorMA( pTemp->entity.prevstate.origin, traceFraction*frametime, pTemp->entity.baseline.origin, pTemp->entity.origin );
+		// Damp velocity
+		damp = pTemp->bounceFactor;
+		if ( pTemp->flags & (FTENT_GRAVITY|FTENT_SLOWGRAVITY) )
+		{
+			damp *= 0.5;
+			if ( traceNormal[2] > 0.9 )		// Hit floor?
+			{
+				if ( pTemp->entity.baseline.origin[2] <= 0 && pTemp->entity.baseline.origin[2] >= gravity*3 )
+				{
+					damp = 0;		// Stop
+					pTemp->flags &= ~(FTENT_ROTATE|FTENT_GRAVITY|FTENT_SLOWGRAVITY|FTENT_COLLIDEWORLD|FTENT_SMOKETRAIL);
+					pTemp->entity.angles[0] = 0;
+					pTemp->entity.angles[2] = 0;
+				}
+			}
+		}
+
+		if (pTemp->hitSound)
+		{
+			Callback_TempEntPlaySound(pTemp, damp);
+		}
+
+		if (pTemp->flags & FTENT_COLLIDEKILL)
+		{
+			// die on impact
+			pTemp->flags &= ~FTENT_FADEOUT;	
+			pTemp->die = client_time;			
+		}
+		else
+		{
+			// Reflect velocity
+			if ( damp != 0 )
+			{
+				proj = DotProduct( pTemp->entity.baseline.origin, traceNormal );
+				VectorMA( pTemp->entity.baseline.origin, -proj*2, traceNormal, pTemp->entity.baseline.origin );
+				// Reflect rotation (fake)
+
+				pTemp->entity.angles[1] = -pTemp->entity.angles[1];
+			}
+			
+			if ( damp != 1 )
+			{
+
+				VectorScale( pTemp->entity.baseline.origin, damp, pTemp->entity.baseline.origin );
+				VectorScale( pTemp->entity.angles, 0.9, pTemp->entity.angles );
+			}
+		}
+	}
+}
+
 /*
 =================
 CL_UpdateTEnts
 
-Simulation and cleanup of temporary entities
+Simulation and cleanup of temporary entities.
+Runs in stages over all tents: expire and move, sprite animation and rotation,
+collision of the tents that want it, then effects and gravity. Each tent still
+goes through the steps in the same order as before.
 =================
 */
 void CL_DLLEXPORT HUD_TempEntUpdate (
@@ -394,9 +562,10 @@ void CL_DLLEXPORT HUD_TempEntUpdate (
 //	RecClTempEntUpdate(frametime, client_time, cl_gravity, ppTempEntFree, ppTempEntActive, Callback_AddVisibleEntity, Callback_TempEntPlaySound);
 
 	static int gTempEntFrame = 0;
-	int			i;
 	TEMPENTITY	*pTemp, *pnext, *pprev;
 	float		freq, gravity, gravitySlow, life, fastFreq;
+	bool		playersSolid = false;
+	size_t		t, numActive;
 
 	Vector		vAngles;
 
@@ -409,18 +578,6 @@ void CL_DLLEXPORT HUD_TempEntUpdate (
 	if ( !*ppTempEntActive )		
 		return;
 
-	// in order to have tents collide with players, we have to run the player prediction code so
-	// that the client has the player list. We run this code once when we detect any COLLIDEALL 
-	// tent, then set this BOOL to true so the code doesn't get run again if there's more than
-	// one COLLIDEALL ent for this update. (often are).
-	gEngfuncs.pEventAPI->EV_SetUpPlayerPrediction( false, true );
-
-	// Store off the old count
-	gEngfuncs.pEventAPI->EV_PushPMStates();
-
-	// Now add in all of the players.
-	gEngfuncs.pEventAPI->EV_SetSolidPlayers ( -1 );	
-
 	// !!!BUGBUG	-- This needs to be time based
 	gTempEntFrame = (gTempEntFrame+1) & 31;
 
@@ -437,7 +594,7 @@ void CL_DLLEXPORT HUD_TempEntUpdate (
 			}
 			pTemp = pTemp->next;
 		}
-		goto finish;
+		return;
 	}
 
 	pprev = NULL;
@@ -446,6 +603,11 @@ void CL_DLLEXPORT HUD_TempEntUpdate (
 	gravity = -frametime * cl_gravity;
 	gravitySlow = gravity * 0.5;
 
+	g_TempEntBatch.Clear();
+	g_rgActiveTemps.clear();
+	g_rgCollideTemps.clear();
+
+	// Expire tents and move the ones with special motion, plain movers go to the batch
 	while ( pTemp )
 	{
 		int active;
@@ -539,217 +701,125 @@ void CL_DLLEXPORT HUD_TempEntUpdate (
 			
 			else 
 			{
-				for ( i = 0; i < 3; i++ ) 
-					pTemp->entity.origin[i] += pTemp->entity.baseline.origin[i] * frametime;
+				g_TempEntBatch.Add( pTemp );
 			}
-			
-			if ( pTemp->flags & FTENT_SPRANIMATE )
+
+			g_rgActiveTemps.push_back( pTemp );
+		}
+		pTemp = pnext;
+	}
+
+	g_TempEntBatch.Integrate( frametime );
+
+	// Animate sprites and rotate, finished sprites drop out of the remaining stages
+	numActive = 0;
+	for ( t = 0; t < g_rgActiveTemps.size(); t++ )
+	{
+		pTemp = g_rgActiveTemps[t];
+
+		if ( pTemp->flags & FTENT_SPRANIMATE )
+		{
+			pTemp->entity.curstate.frame += frametime * pTemp->entity.curstate.framerate;
+			if ( pTemp->entity.curstate.frame >= pTemp->frameMax )
 			{
-				pTemp->entity.curstate.frame += frametime * pTemp->entity.curstate.framerate;
-				if ( pTemp->entity.curstate.frame >= pTemp->frameMax )
-				{
-					pTemp->entity.curstate.frame = pTemp->entity.curstate.frame - (int)(pTemp->entity.curstate.frame);
+				pTemp->entity.curstate.frame = pTemp->entity.curstate.frame - (int)(pTemp->entity.curstate.frame);
 
-					if ( !(pTemp->flags & FTENT_SPRANIMATELOOP) )
-					{
-						// this animating sprite isn't set to loop, so destroy it.
-						pTemp->die = client_time;
-						pTemp = pnext;
-						continue;
-					}
+				if ( !(pTemp->flags & FTENT_SPRANIMATELOOP) )
+				{
+					// this animating sprite isn't set to loop, so destroy it.
+					pTemp->die = client_time;
+					continue;
 				}
 			}
-			else if ( pTemp->flags & FTENT_SPRCYCLE )
+		}
+		else if ( pTemp->flags & FTENT_SPRCYCLE )
+		{
+			pTemp->entity.curstate.frame += frametime * 10;
+			if ( pTemp->entity.curstate.frame >= pTemp->frameMax )
 			{
-				pTemp->entity.curstate.frame += frametime * 10;
-				if ( pTemp->entity.curstate.frame >= pTemp->frameMax )
-				{
-					pTemp->entity.curstate.frame = pTemp->entity.curstate.frame - (int)(pTemp->entity.curstate.frame);
-				}
+				pTemp->entity.curstate.frame = pTemp->entity.curstate.frame - (int)(pTemp->entity.curstate.frame);
 			}
+		}
 // Experiment
 #if 0
-			if ( pTemp->flags & FTENT_SCALE )
-				pTemp->entity.curstate.framerate += 20.0 * (frametime / pTemp->entity.curstate.framerate);
+		if ( pTemp->flags & FTENT_SCALE )
+			pTemp->entity.curstate.framerate += 20.0 * (frametime / pTemp->entity.curstate.framerate);
 #endif
 
-			if ( pTemp->flags & FTENT_ROTATE )
-			{
-				pTemp->entity.angles[0] += pTemp->entity.baseline.angles[0] * frametime;
-				pTemp->entity.angles[1] += pTemp->entity.baseline.angles[1] * frametime;
-				pTemp->entity.angles[2] += pTemp->entity.baseline.angles[2] * frametime;
-
-				VectorCopy( pTemp->entity.angles, pTemp->entity.latched.prevangles );
-			}
-
-			if ( pTemp->flags & (FTENT_COLLIDEALL | FTENT_COLLIDEWORLD) )
-			{
-				vec3_t	traceNormal;
-				float	traceFraction = 1;
-
-				if ( pTemp->flags & FTENT_COLLIDEALL )
-				{
-					pmtrace_t pmtrace;
-					physent_t *pe;
-				
-					gEngfuncs.pEventAPI->EV_SetTraceHull( 2 );
-
-					gEngfuncs.pEventAPI->EV_PlayerTrace( pTemp->entity.prevstate.origin, pTemp->entity.origin, PM_STUDIO_BOX, -1, &pmtrace );
-
-
-					if ( pmtrace.fraction != 1 )
-					{
-						pe = gEngfuncs.pEventAPI->EV_GetPhysent( pmtrace.ent );
-
-						if ( !pmtrace.ent || ( pe->info != pTemp->clientIndex ) )
-						{
-							traceFraction = pmtrace.fraction;
-							VectorCopy( pmtrace.plane.normal, traceNormal );
-
-							if ( pTemp->hitcallback )
-							{
-								(*pTemp->hitcallback)( pTemp, &pmtrace );
-							}
-						}
-					}
-				}
-				else if ( pTemp->flags & FTENT_COLLIDEWORLD )
-				{
-					pmtrace_t pmtrace;
-					
-					gEngfuncs.pEventAPI->EV_SetTraceHull( 2 );
-
-					gEngfuncs.pEventAPI->EV_PlayerTrace( pTemp->entity.prevstate.origin, pTemp->entity.origin, PM_STUDIO_BOX | PM_WORLD_ONLY, -1, &pmtrace );					
+		if ( pTemp->flags & FTENT_ROTATE )
+		{
+			pTemp->entity.angles[0] += pTemp->entity.baseline.angles[0] * frametime;
+			pTemp->entity.angles[1] += pTemp->entity.baseline.angles[1] * frametime;
+			pTemp->entity.angles[2] += pTemp->entity.baseline.angles[2] * frametime;
 
-					if ( pmtrace.fraction != 1 )
-					{
-						traceFraction = pmtrace.fraction;
-						VectorCopy( pmtrace.plane.normal, traceNormal );
-
-						if ( pTemp->flags & FTENT_SPARKSHOWER )
-						{
-							// Chop spark speeds a bit more
-							//
-							VectorScale( pTemp->entity.baseline.origin, 0.6, pTemp->entity.baseline.origin );
-
-							if ( Length( pTemp->entity.baseline.origin ) < 10 )
-							{
-								pTemp->entity.baseline.framerate = 0.0;								
-							}
-						}
-
-						if ( pTemp->hitcallback )
-						{
-							(*pTemp->hitcallback)( pTemp, &pmtrace );
-						}
-					}
-				}
-				
-				if ( traceFraction != 1 )	// Decent collision now, and damping works
-				{
-					float  proj, damp;
+			VectorCopy( pTemp->entity.angles, pTemp->entity.latched.prevangles );
+		}
 
-					// Place at contact point
-					VectorMA( pTemp->entity.prevstate.origin, traceFraction*frametime, pTemp->entity.baseline.origin, pTemp->entity.origin );
-					// Damp velocity
-					damp = pTemp->bounceFactor;
-					if ( pTemp->flags & (FTENT_GRAVITY|FTENT_SLOWGRAVITY) )
-					{
-						damp *= 0.5;
-						if ( traceNormal[2] > 0.9 )		// Hit floor?
-						{
-							if ( pTemp->entity.baseline.origin[2] <= 0 && pTemp->entity.baseline.origin[2] >= gravity*3 )
-							{
-								damp = 0;		// Stop
-								pTemp->flags &= ~(FTENT_ROTATE|FTENT_GRAVITY|FTENT_SLOWGRAVITY|FTENT_COLLIDEWORLD|FTENT_SMOKETRAIL);
-								pTemp->entity.angles[0] = 0;
-								pTemp->entity.angles[2] = 0;
-							}
-						}
-					}
+		if ( pTemp->flags & (FTENT_COLLIDEALL | FTENT_COLLIDEWORLD) )
+		{
+			g_rgCollideTemps.push_back( pTemp );
+		}
 
-					if (pTemp->hitSound)
-					{
-						Callback_TempEntPlaySound(pTemp, damp);
-					}
+		g_rgActiveTemps[numActive++] = pTemp;
+	}
+	g_rgActiveTemps.resize( numActive );
 
-					if (pTemp->flags & FTENT_COLLIDEKILL)
-					{
-						// die on impact
-						pTemp->flags &= ~FTENT_FADEOUT;	
-						pTemp->die = client_time;			
-					}
-					else
-					{
-						// Reflect velocity
-						if ( damp != 0 )
-						{
-							proj = DotProduct( pTemp->entity.baseline.origin, traceNormal );
-							VectorMA( pTemp->entity.baseline.origin, -proj*2, traceNormal, pTemp->entity.baseline.origin );
-							// Reflect rotation (fake)
-
-							pTemp->entity.angles[1] = -pTemp->entity.angles[1];
-						}
-						
-						if ( damp != 1 )
-						{
-
-							VectorScale( pTemp->entity.baseline.origin, damp, pTemp->entity.baseline.origin );
-							VectorScale( pTemp->entity.angles, 0.9, pTemp->entity.angles );
-						}
-					}
-				}
-			}
+	// Only tents flagged for collision get traced
+	for ( t = 0; t < g_rgCollideTemps.size(); t++ )
+	{
+		TempEntCollide( g_rgCollideTemps[t], frametime, client_time, gravity, &playersSolid, Callback_TempEntPlaySound );
+	}
 
+	for ( t = 0; t < g_rgActiveTemps.size(); t++ )
+	{
+		pTemp = g_rgActiveTemps[t];
 
-			if ( (pTemp->flags & FTENT_FLICKER) && gTempEntFrame == pTemp->entity.curstate.effects )
-			{
-				dlight_t *dl = gEngfuncs.pEfxAPI->CL_AllocDlight (0);
-				VectorCopy (pTemp->entity.origin, dl->origin);
-				dl->radius = 60;
-				dl->color.r = 255;
-				dl->color.g = 120;
-				dl->color.b = 0;
-				dl->die = client_time + 0.01;
-			}
+		if ( (pTemp->flags & FTENT_FLICKER) && gTempEntFrame == pTemp->entity.curstate.effects )
+		{
+			dlight_t *dl = gEngfuncs.pEfxAPI->CL_AllocDlight (0);
+			VectorCopy (pTemp->entity.origin, dl->origin);
+			dl->radius = 60;
+			dl->color.r = 255;
+			dl->color.g = 120;
+			dl->color.b = 0;
+			dl->die = client_time + 0.01;
+		}
 
-			if ( pTemp->flags & FTENT_SMOKETRAIL )
-			{
-				gEngfuncs.pEfxAPI->R_RocketTrail (pTemp->entity.prevstate.origin, pTemp->entity.origin, 1);
-			}
+		if ( pTemp->flags & FTENT_SMOKETRAIL )
+		{
+			gEngfuncs.pEfxAPI->R_RocketTrail (pTemp->entity.prevstate.origin, pTemp->entity.origin, 1);
+		}
 
-			if ( pTemp->flags & FTENT_GRAVITY )
-				pTemp->entity.baseline.origin[2] += gravity;
-			else if ( pTemp->flags & FTENT_SLOWGRAVITY )
-				pTemp->entity.baseline.origin[2] += gravitySlow;
+		if ( pTemp->flags & FTENT_GRAVITY )
+			pTemp->entity.baseline.origin[2] += gravity;
+		else if ( pTemp->flags & FTENT_SLOWGRAVITY )
+			pTemp->entity.baseline.origin[2] += gravitySlow;
 
-			if ( pTemp->flags & FTENT_CLIENTCUSTOM )
+		if ( pTemp->flags & FTENT_CLIENTCUSTOM )
+		{
+			if ( pTemp->callback )
 			{
-				if ( pTemp->callback )
-				{
-					( *pTemp->callback )( pTemp, frametime, client_time );
-				}
+				( *pTemp->callback )( pTemp, frametime, client_time );
 			}
+		}
 
-			// Cull to PVS (not frustum cull, just PVS)
-			if ( !(pTemp->flags & FTENT_NOMODEL ) )
+		// Cull to PVS (not frustum cull, just PVS)
+		if ( !(pTemp->flags & FTENT_NOMODEL ) )
+		{
+			if ( !Callback_AddVisibleEntity( &pTemp->entity ) )
 			{
-				if ( !Callback_AddVisibleEntity( &pTemp->entity ) )
+				if ( !(pTemp->flags & FTENT_PERSIST) ) 
 				{
-					if ( !(pTemp->flags & FTENT_PERSIST) ) 
-					{
-						pTemp->die = client_time;			// If we can't draw it this frame, just dump it.
-						pTemp->flags &= ~FTENT_FADEOUT;	// Don't fade out, just die
-					}
+					pTemp->die = client_time;			// If we can't draw it this frame, just dump it.
+					pTemp->flags &= ~FTENT_FADEOUT;	// Don't fade out, just die
 				}
 			}
 		}
-		pTemp = pnext;
 	}
 
-finish:
 	// Restore state info
-	gEngfuncs.pEventAPI->EV_PopPMStates();
+	if ( playersSolid )
+		gEngfuncs.pEventAPI->EV_PopPMStates();
 }
 
 /*
@@ -158,6 +158,9 @@ void GameModeGUI_RefreshConfigFiles() {
 	configAmount = 0;
 	configCompleted = 0;
 
+	// Records could have been saved by the server since the last refresh
+	CustomGameModeRecordStore::Get().Refresh();
+
 	auto configTypes = std::vector<CONFIG_TYPE>( {
 		CONFIG_TYPE_MAP,
 		CONFIG_TYPE_CGM
@@ -624,7 +624,10 @@ private:
 
 	bool paused;
 
+	// Server only sends the timer when it stops advancing at rate from this value
 	float time;
+	float timeRate;
+	float timeReceived;
 	
 	bool blinked;
 	float nextTimerBlinkTime;
@@ -687,7 +690,11 @@ private:
 
 	int currentScore;
 	int comboMultiplier;
+
+	// Decays at rate from the last value sent
 	float comboMultiplierReset;
+	float comboMultiplierResetRate;
+	float comboMultiplierResetReceived;
 };
 
 class CHudCentralLabel : public CHudBase {
@@ -23,10 +23,12 @@ extern "C"
 #include <ctype.h>
 #include "Exports.h"
 #include "custom_gamemode_config.h"
+#include "custom_gamemode_record_store.h"
 #include "soundmanager.h"
 #include "event_api.h"
 #include "fs_aux.h"
 #include "shared_memory.h"
+#include "input_replay.h"
 
 #include "vgui_TeamFortressViewport.h"
 
@@ -872,6 +874,8 @@ void CL_DLLEXPORT CL_CreateMove ( float frametime, struct usercmd_s *cmd, int ac
 	}
 
 	Bench_SetViewAngles( 1, (float *)&cmd->viewangles, frametime, cmd );
+
+	g_InputReplay.CreateMove( frametime, cmd, active );
 }
 
 /*
@@ -1125,6 +1129,8 @@ InitInput
 */
 void InitInput (void)
 {
+	g_InputReplay.Init();
+
 	gEngfuncs.pfnAddCommand ("+moveup",IN_UpDown);
 	gEngfuncs.pfnAddCommand ("-moveup",IN_UpUp);
 	gEngfuncs.pfnAddCommand ("+movedown",IN_DownDown);
@@ -1292,6 +1298,8 @@ void CL_UnloadParticleMan( void );
 void ClearEventList( void );
 #endif
 
+void R_StudioShutdown( void );
+
 void CL_DLLEXPORT HUD_Shutdown( void )
 {
 //	RecClShutdown();
@@ -1303,4 +1311,8 @@ void CL_DLLEXPORT HUD_Shutdown( void )
 #endif
 	
 	CL_UnloadParticleMan();
+
+	R_StudioShutdown();
+
+	CustomGameModeRecordStore::Get().Shutdown();
 }
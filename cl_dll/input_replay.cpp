@@ -0,0 +1,550 @@
+// input_replay.cpp
+// records and plays back movement commands for repeatable runs
+
+#include "hud.h"
+#include "cl_util.h"
+#include "usercmd.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <filesystem>
+#include <algorithm>
+
+#include "input_replay.h"
+
+#define REPLAY_MAGIC		"HLRP"
+#define REPLAY_VERSION		1
+
+// Header: magic, version, frame count, cgm_seed, start command
+#define REPLAY_FRAMES_OFFSET	8
+
+enum
+{
+	REPLAY_EVENT_CMD = 1,
+	REPLAY_EVENT_CVAR,
+	REPLAY_EVENT_VOTE,
+};
+
+// Fields of usercmd_t in the order of the changed bits written with each command
+static const struct
+{
+	size_t	offset;
+	size_t	size;
+} g_ReplayCmdFields[] =
+{
+	{ offsetof( usercmd_t, lerp_msec ),			sizeof( short ) },
+	{ offsetof( usercmd_t, msec ),				sizeof( byte ) },
+	{ offsetof( usercmd_t, viewangles ),		sizeof( vec3_t ) },
+	{ offsetof( usercmd_t, forwardmove ),		sizeof( float ) },
+	{ offsetof( usercmd_t, sidemove ),			sizeof( float ) },
+	{ offsetof( usercmd_t, upmove ),			sizeof( float ) },
+	{ offsetof( usercmd_t, lightlevel ),		sizeof( byte ) },
+	{ offsetof( usercmd_t, buttons ),			sizeof( unsigned short ) },
+	{ offsetof( usercmd_t, impulse ),			sizeof( byte ) },
+	{ offsetof( usercmd_t, weaponselect ),		sizeof( byte ) },
+	{ offsetof( usercmd_t, impact_index ),		sizeof( int ) },
+	{ offsetof( usercmd_t, impact_position ),	sizeof( vec3_t ) },
+};
+
+#define NUM_REPLAY_CMD_FIELDS	( sizeof( g_ReplayCmdFields ) / sizeof( g_ReplayCmdFields[0] ) )
+
+// Cvars which change how the server simulates a frame
+static const char *g_rgszReplayCvars[] =
+{
+	"host_framerate",
+	"fps_max",
+	"skill",
+};
+
+#define NUM_REPLAY_CVARS	( sizeof( g_rgszReplayCvars ) / sizeof( g_rgszReplayCvars[0] ) )
+
+CInputReplay g_InputReplay;
+
+static std::string ReplayPath( const char *directory, const std::string &name, const char *extension )
+{
+	std::string path = std::string( gEngfuncs.pfnGetGameDirectory() ) + "/" + directory;
+
+	std::error_code error;
+	std::filesystem::create_directories( path, error );
+
+	return path + "/" + name + extension;
+}
+
+static void WriteReplayString( FILE *file, const std::string &s )
+{
+	unsigned short length = (unsigned short)s.size();
+
+	fwrite( &length, sizeof( length ), 1, file );
+	fwrite( s.c_str(), 1, length, file );
+}
+
+static bool ReadReplayString( FILE *file, std::string &s )
+{
+	unsigned short length;
+	if ( fread( &length, sizeof( length ), 1, file ) != 1 )
+		return false;
+
+	s.resize( length );
+	return !length || fread( &s[0], 1, length, file ) == length;
+}
+
+static void Replay_Record( void )
+{
+	if ( gEngfuncs.Cmd_Argc() < 2 )
+	{
+		gEngfuncs.Con_Printf( "usage: replay_record <name> [\"<command starting the run>\"]\n" );
+		return;
+	}
+
+	g_InputReplay.Record( gEngfuncs.Cmd_Argv( 1 ), gEngfuncs.Cmd_Argc() > 2 ? gEngfuncs.Cmd_Argv( 2 ) : "" );
+}
+
+static void Replay_Play( void )
+{
+	if ( gEngfuncs.Cmd_Argc() < 2 )
+	{
+		gEngfuncs.Con_Printf( "usage: replay_play <name> [profile tag]\n" );
+		return;
+	}
+
+	g_InputReplay.Play( gEngfuncs.Cmd_Argv( 1 ), gEngfuncs.Cmd_Argc() > 2 ? gEngfuncs.Cmd_Argv( 2 ) : "latest" );
+}
+
+static void Replay_Stop( void )
+{
+	g_InputReplay.Stop();
+}
+
+/*
+====================
+ReadProfileCSV
+
+Game DLL time of each frame from a profile CSV written by sv_profile,
+which is the sum of the *_ms columns after frame_ms
+====================
+*/
+static bool ReadProfileCSV( const std::string &name, std::vector<double> &frames )
+{
+	std::string path = ReplayPath( "profile", name, ".csv" );
+
+	FILE *file = fopen( path.c_str(), "r" );
+	if ( !file )
+	{
+		gEngfuncs.Con_Printf( "Couldn't open %s\n", path.c_str() );
+		return false;
+	}
+
+	char line[1024];
+	int firstSection = -1;
+
+	if ( fgets( line, sizeof( line ), file ) )
+	{
+		int column = 0;
+		for ( char *token = strtok( line, ",\r\n" ); token; token = strtok( NULL, ",\r\n" ), column++ )
+		{
+			if ( !strcmp( token, "frame_ms" ) )
+				firstSection = column + 1;
+		}
+	}
+
+	if ( firstSection < 0 )
+	{
+		gEngfuncs.Con_Printf( "%s is not a server profile\n", path.c_str() );
+		fclose( file );
+		return false;
+	}
+
+	while ( fgets( line, sizeof( line ), file ) )
+	{
+		double total = 0;
+		int column = 0;
+		for ( char *token = strtok( line, ",\r\n" ); token; token = strtok( NULL, ",\r\n" ), column++ )
+		{
+			if ( column >= firstSection )
+				total += atof( token );
+		}
+
+		frames.push_back( total );
+	}
+
+	fclose( file );
+	return true;
+}
+
+/*
+====================
+Replay_Compare
+
+replay_compare <base> <new> [percent]
+Flags frames of the new profile whose game DLL time grew by more than percent
+====================
+*/
+static void Replay_Compare( void )
+{
+	// Differences below this are timer noise
+	const double noiseMsec = 0.05;
+
+	if ( gEngfuncs.Cmd_Argc() < 3 )
+	{
+		gEngfuncs.Con_Printf( "usage: replay_compare <base profile> <new profile> [percent, default 10]\n" );
+		return;
+	}
+
+	std::vector<double> base, current;
+	if ( !ReadProfileCSV( gEngfuncs.Cmd_Argv( 1 ), base ) || !ReadProfileCSV( gEngfuncs.Cmd_Argv( 2 ), current ) )
+		return;
+
+	double threshold = gEngfuncs.Cmd_Argc() > 3 ? atof( gEngfuncs.Cmd_Argv( 3 ) ) : 10.0;
+
+	size_t count = min( base.size(), current.size() );
+	if ( base.size() != current.size() )
+		gEngfuncs.Con_Printf( "Profiles have %d and %d frames, comparing the first %d\n", (int)base.size(), (int)current.size(), (int)count );
+
+	double baseTotal = 0, currentTotal = 0;
+	std::vector<std::pair<double, int>> regressions;
+
+	for ( size_t i = 0; i < count; i++ )
+	{
+		baseTotal += base[i];
+		currentTotal += current[i];
+
+		double difference = current[i] - base[i];
+		if ( difference > noiseMsec && current[i] > base[i] * ( 1.0 + threshold / 100.0 ) )
+			regressions.push_back( std::make_pair( difference, (int)i ) );
+	}
+
+	if ( !count )
+		return;
+
+	gEngfuncs.Con_Printf( "Game DLL time per frame: %.3f ms -> %.3f ms\n", baseTotal / count, currentTotal / count );
+	gEngfuncs.Con_Printf( "%d of %d frames regressed by more than %.0f%%\n", (int)regressions.size(), (int)count, threshold );
+
+	std::sort( regressions.rbegin(), regressions.rend() );
+	for ( size_t i = 0; i < regressions.size() && i < 10; i++ )
+	{
+		int frame = regressions[i].second;
+		gEngfuncs.Con_Printf( "  frame %d: %.3f ms -> %.3f ms\n", frame, base[frame], current[frame] );
+	}
+}
+
+/*
+====================
+CInputReplay
+
+====================
+*/
+CInputReplay::CInputReplay( void )
+{
+	m_nState = REPLAY_IDLE;
+	m_pFile = NULL;
+	m_nFrames = 0;
+	memset( &m_LastCmd, 0, sizeof( m_LastCmd ) );
+}
+
+void CInputReplay::Init( void )
+{
+	gEngfuncs.pfnAddCommand( "replay_record", Replay_Record );
+	gEngfuncs.pfnAddCommand( "replay_play", Replay_Play );
+	gEngfuncs.pfnAddCommand( "replay_stop", Replay_Stop );
+	gEngfuncs.pfnAddCommand( "replay_compare", Replay_Compare );
+}
+
+/*
+====================
+Record
+
+cgm_seed is fixed for the run, so custom game modes pick the same random spawns
+and gungame weapons again on playback
+====================
+*/
+void CInputReplay::Record( const char *name, const char *startCommand )
+{
+	Stop();
+
+	std::string path = ReplayPath( "replays", name, ".hlr" );
+	m_pFile = fopen( path.c_str(), "wb" );
+	if ( !m_pFile )
+	{
+		gEngfuncs.Con_Printf( "Couldn't create %s\n", path.c_str() );
+		return;
+	}
+
+	int seed = (int)gEngfuncs.pfnGetCvarFloat( "cgm_seed" );
+	if ( !seed )
+	{
+		seed = gEngfuncs.pfnRandomLong( 1, 10000 );
+		gEngfuncs.Cvar_SetValue( "cgm_seed", seed );
+	}
+
+	int version = REPLAY_VERSION;
+	m_nFrames = 0;
+	fwrite( REPLAY_MAGIC, 1, 4, m_pFile );
+	fwrite( &version, sizeof( version ), 1, m_pFile );
+	fwrite( &m_nFrames, sizeof( m_nFrames ), 1, m_pFile );
+	fwrite( &seed, sizeof( seed ), 1, m_pFile );
+	WriteReplayString( m_pFile, startCommand );
+
+	m_szName = name;
+	m_szStartCommand = startCommand;
+	m_nState = REPLAY_RECORD_WAIT;
+
+	// Unknown values, so the first frame stores all of them
+	memset( &m_LastCmd, 0xff, sizeof( m_LastCmd ) );
+	m_LastCvarValues.assign( NUM_REPLAY_CVARS, -1.0f );
+
+	gEngfuncs.Con_Printf( "Recording %s\n", path.c_str() );
+
+	if ( !m_szStartCommand.empty() )
+		gEngfuncs.pfnClientCmd( (char *)( m_szStartCommand + "\n" ).c_str() );
+}
+
+/*
+====================
+Play
+
+====================
+*/
+void CInputReplay::Play( const char *name, const char *tag )
+{
+	Stop();
+
+	std::string path = ReplayPath( "replays", name, ".hlr" );
+	m_pFile = fopen( path.c_str(), "rb" );
+	if ( !m_pFile )
+	{
+		gEngfuncs.Con_Printf( "Couldn't open %s\n", path.c_str() );
+		return;
+	}
+
+	char magic[4];
+	int version, seed;
+	if ( fread( magic, 1, 4, m_pFile ) != 4 || memcmp( magic, REPLAY_MAGIC, 4 ) ||
+		fread( &version, sizeof( version ), 1, m_pFile ) != 1 || version != REPLAY_VERSION ||
+		fread( &m_nFrames, sizeof( m_nFrames ), 1, m_pFile ) != 1 ||
+		fread( &seed, sizeof( seed ), 1, m_pFile ) != 1 ||
+		!ReadReplayString( m_pFile, m_szStartCommand ) )
+	{
+		gEngfuncs.Con_Printf( "%s is not a replay of this version\n", path.c_str() );
+		fclose( m_pFile );
+		m_pFile = NULL;
+		return;
+	}
+
+	m_szName = std::string( name ) + "_" + tag;
+	m_nState = REPLAY_PLAY_WAIT;
+	memset( &m_LastCmd, 0, sizeof( m_LastCmd ) );
+
+	gEngfuncs.Cvar_SetValue( "cgm_seed", seed );
+
+	gEngfuncs.Con_Printf( "Playing %s, %d frames\n", path.c_str(), m_nFrames );
+
+	if ( !m_szStartCommand.empty() )
+		gEngfuncs.pfnClientCmd( (char *)( m_szStartCommand + "\n" ).c_str() );
+}
+
+/*
+====================
+Stop
+
+====================
+*/
+void CInputReplay::Stop( void )
+{
+	if ( m_nState == REPLAY_RECORDING || m_nState == REPLAY_RECORD_WAIT )
+	{
+		fseek( m_pFile, REPLAY_FRAMES_OFFSET, SEEK_SET );
+		fwrite( &m_nFrames, sizeof( m_nFrames ), 1, m_pFile );
+		gEngfuncs.Con_Printf( "Recorded %d frames\n", m_nFrames );
+	}
+	else if ( m_nState == REPLAY_PLAYING )
+	{
+		gEngfuncs.Con_Printf( "Replay finished, server profile goes to profile/%s.csv\n", m_szName.c_str() );
+	}
+
+	if ( m_pFile )
+	{
+		fclose( m_pFile );
+		m_pFile = NULL;
+	}
+
+	m_nState = REPLAY_IDLE;
+}
+
+/*
+====================
+RecordVote
+
+====================
+*/
+void CInputReplay::RecordVote( int modIndex, const char *voter )
+{
+	if ( m_nState != REPLAY_RECORDING )
+		return;
+
+	byte event = REPLAY_EVENT_VOTE;
+	byte index = (byte)modIndex;
+
+	fwrite( &event, 1, 1, m_pFile );
+	fwrite( &index, 1, 1, m_pFile );
+	WriteReplayString( m_pFile, voter );
+}
+
+/*
+====================
+WriteCvarChanges
+
+====================
+*/
+void CInputReplay::WriteCvarChanges( void )
+{
+	for ( size_t i = 0; i < NUM_REPLAY_CVARS; i++ )
+	{
+		float value = gEngfuncs.pfnGetCvarFloat( (char *)g_rgszReplayCvars[i] );
+		if ( value == m_LastCvarValues[i] )
+			continue;
+
+		m_LastCvarValues[i] = value;
+
+		byte event = REPLAY_EVENT_CVAR;
+		byte cvar = (byte)i;
+
+		fwrite( &event, 1, 1, m_pFile );
+		fwrite( &cvar, 1, 1, m_pFile );
+		fwrite( &value, sizeof( value ), 1, m_pFile );
+	}
+}
+
+/*
+====================
+WriteCmd
+
+Event byte, bits of the fields that changed, then those fields. Frame time
+isn't stored, host_framerate sets the tick of the server on playback
+====================
+*/
+void CInputReplay::WriteCmd( const usercmd_t *cmd )
+{
+	unsigned short changed = 0;
+
+	for ( size_t i = 0; i < NUM_REPLAY_CMD_FIELDS; i++ )
+	{
+		if ( memcmp( (const byte *)cmd + g_ReplayCmdFields[i].offset, (const byte *)&m_LastCmd + g_ReplayCmdFields[i].offset, g_ReplayCmdFields[i].size ) )
+			changed |= 1 << i;
+	}
+
+	byte event = REPLAY_EVENT_CMD;
+	fwrite( &event, 1, 1, m_pFile );
+	fwrite( &changed, sizeof( changed ), 1, m_pFile );
+
+	for ( size_t i = 0; i < NUM_REPLAY_CMD_FIELDS; i++ )
+	{
+		if ( changed & ( 1 << i ) )
+			fwrite( (const byte *)cmd + g_ReplayCmdFields[i].offset, 1, g_ReplayCmdFields[i].size, m_pFile );
+	}
+
+	m_LastCmd = *cmd;
+	m_nFrames++;
+}
+
+/*
+====================
+ReadFrame
+
+Applies events up to the next command, false at the end of the recording
+====================
+*/
+bool CInputReplay::ReadFrame( usercmd_t *cmd )
+{
+	byte event;
+
+	while ( fread( &event, 1, 1, m_pFile ) == 1 )
+	{
+		if ( event == REPLAY_EVENT_CMD )
+		{
+			unsigned short changed;
+
+			if ( fread( &changed, sizeof( changed ), 1, m_pFile ) != 1 )
+				return false;
+
+			for ( size_t i = 0; i < NUM_REPLAY_CMD_FIELDS; i++ )
+			{
+				if ( ( changed & ( 1 << i ) ) && fread( (byte *)&m_LastCmd + g_ReplayCmdFields[i].offset, 1, g_ReplayCmdFields[i].size, m_pFile ) != g_ReplayCmdFields[i].size )
+					return false;
+			}
+
+			*cmd = m_LastCmd;
+			return true;
+		}
+		else if ( event == REPLAY_EVENT_CVAR )
+		{
+			byte cvar;
+			float value;
+
+			if ( fread( &cvar, 1, 1, m_pFile ) != 1 || fread( &value, sizeof( value ), 1, m_pFile ) != 1 || cvar >= NUM_REPLAY_CVARS )
+				return false;
+
+			gEngfuncs.Cvar_SetValue( (char *)g_rgszReplayCvars[cvar], value );
+		}
+		else if ( event == REPLAY_EVENT_VOTE )
+		{
+			byte index;
+			std::string voter;
+
+			if ( fread( &index, 1, 1, m_pFile ) != 1 || !ReadReplayString( m_pFile, voter ) )
+				return false;
+
+			char command[256];
+			sprintf( command, "gameplay_mod_replay_vote \"%.64s\" %d\n", voter.c_str(), index );
+			gEngfuncs.pfnClientCmd( command );
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return false;
+}
+
+/*
+====================
+CreateMove
+
+Frames where the client isn't in game yet aren't recorded or played back
+====================
+*/
+void CInputReplay::CreateMove( float frametime, usercmd_t *cmd, int active )
+{
+	if ( m_nState == REPLAY_IDLE || !active )
+		return;
+
+	switch ( m_nState )
+	{
+	case REPLAY_RECORD_WAIT:
+		m_nState = REPLAY_RECORDING;
+		// fall through
+	case REPLAY_RECORDING:
+		WriteCvarChanges();
+		WriteCmd( cmd );
+		break;
+
+	case REPLAY_PLAY_WAIT:
+		{
+			char command[256];
+			sprintf( command, "sv_profile_name \"%.128s\"; sv_profile %d\n", m_szName.c_str(), m_nFrames );
+			gEngfuncs.pfnClientCmd( command );
+
+			m_nState = REPLAY_PLAYING;
+		}
+		// fall through
+	case REPLAY_PLAYING:
+		if ( !ReadFrame( cmd ) )
+		{
+			Stop();
+			return;
+		}
+
+		gEngfuncs.SetViewAngles( cmd->viewangles );
+		break;
+	}
+}
@@ -0,0 +1,68 @@
+#if !defined ( INPUT_REPLAY_H )
+#define INPUT_REPLAY_H
+#if defined( _WIN32 )
+#pragma once
+#endif
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// usercmd.h has to be included before this
+
+/*
+====================
+CInputReplay
+
+Records the movement commands built each frame, changes of cvars that affect
+the simulation and random gameplay mod votes into replays/<name>.hlr, and plays
+them back in place of the player's input. Playback turns on sv_profile for the
+length of the recording, so every replay leaves a profile/<name>_<tag>.csv of
+server frame timings that replay_compare can hold against another build's.
+====================
+*/
+class CInputReplay
+{
+public:
+	CInputReplay( void );
+
+	void Init( void );
+
+	// Called at the end of CL_CreateMove
+	void CreateMove( float frametime, struct usercmd_s *cmd, int active );
+
+	// Vote that reached the HUD, modIndex as typed in chat
+	void RecordVote( int modIndex, const char *voter );
+
+	void Record( const char *name, const char *startCommand );
+	void Play( const char *name, const char *tag );
+	void Stop( void );
+
+private:
+	void WriteCmd( const struct usercmd_s *cmd );
+	void WriteCvarChanges( void );
+	bool ReadFrame( struct usercmd_s *cmd );
+
+	enum
+	{
+		REPLAY_IDLE = 0,
+		REPLAY_RECORD_WAIT,		// start command issued, waiting to be in game
+		REPLAY_RECORDING,
+		REPLAY_PLAY_WAIT,
+		REPLAY_PLAYING,
+	};
+
+	int					m_nState;
+	FILE				*m_pFile;
+	std::string			m_szName;
+	std::string			m_szStartCommand;
+	int					m_nFrames;
+
+	// Previous command, each frame only stores fields that changed
+	usercmd_t			m_LastCmd;
+	std::vector<float>	m_LastCvarValues;
+};
+
+extern CInputReplay g_InputReplay;
+
+#endif // INPUT_REPLAY_H
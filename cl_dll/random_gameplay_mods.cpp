@@ -6,6 +6,8 @@
 #include "cpp_aux.h"
 #include "../fmt/printf.h"
 #include "gameplay_mod.h"
+#include "usercmd.h"
+#include "input_replay.h"
 
 DECLARE_MESSAGE( m_RandomGameplayMods, PropModVin )
 
@@ -181,6 +183,9 @@ int CHudRandomGameplayMods::MsgFunc_PropModVin( const char *pszName, int iSize,
 		}
 
 		voters.push_back( { 255, READ_STRING() } );
+
+		// Mods are listed in reverse, votes are typed starting from 1
+		g_InputReplay.RecordVote( proposedGameplayModsClient.size() - index, voters.back().name.c_str() );
 	}
 
 	m_iFlags |= HUD_ACTIVE;
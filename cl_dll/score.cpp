@@ -26,6 +26,8 @@ void CHudScore::Reset( void )
 	currentScore = 0;
 	comboMultiplier = 1;
 	comboMultiplierReset = 0.0f;
+	comboMultiplierResetRate = 0.0f;
+	comboMultiplierResetReceived = 0.0f;
 
 	yOffset = 0;
 }
@@ -53,7 +55,8 @@ int CHudScore::Draw( float flTime )
 		int r2 = r;
 		int g2 = g;
 		int b2 = b;
-		int alpha = ( comboMultiplierReset / 8.0f ) * 1024;
+		float currentReset = max( 0.0f, comboMultiplierReset - comboMultiplierResetRate * ( flTime - comboMultiplierResetReceived ) );
+		int alpha = ( currentReset / 8.0f ) * 1024;
 		if ( alpha > 255 ) {
 			alpha = 255;
 		}
@@ -74,6 +77,8 @@ int CHudScore::MsgFunc_ScoreValue( const char *pszName, int iSize, void *pbuf )
 	currentScore = READ_LONG();
 	comboMultiplier = READ_LONG();
 	comboMultiplierReset = READ_FLOAT();
+	comboMultiplierResetRate = READ_FLOAT();
+	comboMultiplierResetReceived = gEngfuncs.GetClientTime();
 	yOffset = READ_LONG();
 
 	m_iFlags |= HUD_ACTIVE;
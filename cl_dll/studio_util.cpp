@@ -12,6 +12,10 @@
 #include "com_model.h"
 #include "studio_util.h"
 
+#if defined( STUDIO_SSE2 )
+#include <emmintrin.h>
+#endif
+
 /*
 ====================
 AngleMatrix
@@ -99,6 +103,27 @@ ConcatTransforms
 */
 void ConcatTransforms (float in1[3][4], float in2[3][4], float out[3][4])
 {
+#if defined( STUDIO_SSE2 )
+	__m128 row0 = _mm_loadu_ps( in2[0] );
+	__m128 row1 = _mm_loadu_ps( in2[1] );
+	__m128 row2 = _mm_loadu_ps( in2[2] );
+
+	// in1 translation is only added to the last column, other lanes are kept as they are
+	// instead of adding 0.0, which would turn -0.0 into 0.0
+	const __m128 translationMask = _mm_castsi128_ps( _mm_set_epi32( -1, 0, 0, 0 ) );
+
+	for (int i = 0; i < 3; i++)
+	{
+		__m128 row = _mm_mul_ps( _mm_set1_ps( in1[i][0] ), row0 );
+		row = _mm_add_ps( row, _mm_mul_ps( _mm_set1_ps( in1[i][1] ), row1 ) );
+		row = _mm_add_ps( row, _mm_mul_ps( _mm_set1_ps( in1[i][2] ), row2 ) );
+
+		__m128 translated = _mm_add_ps( row, _mm_set1_ps( in1[i][3] ) );
+		row = _mm_or_ps( _mm_and_ps( translationMask, translated ), _mm_andnot_ps( translationMask, row ) );
+
+		_mm_storeu_ps( out[i], row );
+	}
+#else
 	out[0][0] = in1[0][0] * in2[0][0] + in1[0][1] * in2[1][0] +
 				in1[0][2] * in2[2][0];
 	out[0][1] = in1[0][0] * in2[0][1] + in1[0][1] * in2[1][1] +
@@ -123,6 +148,7 @@ void ConcatTransforms (float in1[3][4], float in2[3][4], float out[3][4])
 				in1[2][2] * in2[2][2];
 	out[2][3] = in1[2][0] * in2[0][3] + in1[2][1] * in2[1][3] +
 				in1[2][2] * in2[2][3] + in1[2][3];
+#endif
 }
 
 // angles index are not the same as ROLL, PITCH, YAW
@@ -199,9 +225,13 @@ void QuaternionSlerp( vec4_t p, vec4_t q, float t, vec4_t qt )
 			sclp = 1.0 - t;
 			sclq = t;
 		}
+#if defined( STUDIO_SSE2 )
+		_mm_storeu_ps( qt, _mm_add_ps( _mm_mul_ps( _mm_set1_ps( sclp ), _mm_loadu_ps( p ) ), _mm_mul_ps( _mm_set1_ps( sclq ), _mm_loadu_ps( q ) ) ) );
+#else
 		for (i = 0; i < 4; i++) {
 			qt[i] = sclp * p[i] + sclq * q[i];
 		}
+#endif
 	}
 	else
 	{
@@ -226,6 +256,44 @@ QuaternionMatrix
 */
 void QuaternionMatrix( vec4_t quaternion, float (*matrix)[4] )
 {
+#if defined( STUDIO_SSE2 )
+	// Scalar version is evaluated in double precision, so are the kernels
+	const __m128d two = _mm_set1_pd( 2.0 );
+	double q0 = quaternion[0], q1 = quaternion[1], q2 = quaternion[2], q3 = quaternion[3];
+	double result[2];
+
+	// ( 2 * q0 * q1, 2 * q1 * q2 ) and ( 2 * q3 * q2, 2 * q3 * q0 )
+	__m128d a = _mm_mul_pd( _mm_mul_pd( two, _mm_set_pd( q1, q0 ) ), _mm_set_pd( q2, q1 ) );
+	__m128d b = _mm_mul_pd( _mm_mul_pd( two, _mm_set_pd( q3, q3 ) ), _mm_set_pd( q0, q2 ) );
+
+	_mm_storeu_pd( result, _mm_add_pd( a, b ) );
+	matrix[1][0] = result[0];
+	matrix[2][1] = result[1];
+
+	_mm_storeu_pd( result, _mm_sub_pd( a, b ) );
+	matrix[0][1] = result[0];
+	matrix[1][2] = result[1];
+
+	// ( 2 * q0 * q2, 2 * q3 * q1 )
+	__m128d c = _mm_mul_pd( _mm_mul_pd( two, _mm_set_pd( q3, q0 ) ), _mm_set_pd( q1, q2 ) );
+	__m128d cSwapped = _mm_shuffle_pd( c, c, 1 );
+
+	_mm_storeu_pd( result, _mm_add_pd( c, cSwapped ) );
+	matrix[0][2] = result[0];
+
+	_mm_storeu_pd( result, _mm_sub_pd( c, cSwapped ) );
+	matrix[2][0] = result[0];
+
+	// ( 1 - 2 * q1 * q1 - 2 * q2 * q2, 1 - 2 * q0 * q0 - 2 * q2 * q2 )
+	__m128d squares = _mm_mul_pd( _mm_mul_pd( two, _mm_set_pd( q0, q1 ) ), _mm_set_pd( q0, q1 ) );
+	__m128d squareZ = _mm_mul_pd( _mm_mul_pd( two, _mm_set1_pd( q2 ) ), _mm_set1_pd( q2 ) );
+
+	_mm_storeu_pd( result, _mm_sub_pd( _mm_sub_pd( _mm_set1_pd( 1.0 ), squares ), squareZ ) );
+	matrix[0][0] = result[0];
+	matrix[1][1] = result[1];
+
+	matrix[2][2] = 1.0 - 2.0 * quaternion[0] * quaternion[0] - 2.0 * quaternion[1] * quaternion[1];
+#else
 	matrix[0][0] = 1.0 - 2.0 * quaternion[1] * quaternion[1] - 2.0 * quaternion[2] * quaternion[2];
 	matrix[1][0] = 2.0 * quaternion[0] * quaternion[1] + 2.0 * quaternion[3] * quaternion[2];
 	matrix[2][0] = 2.0 * quaternion[0] * quaternion[2] - 2.0 * quaternion[3] * quaternion[1];
@@ -237,6 +305,7 @@ void QuaternionMatrix( vec4_t quaternion, float (*matrix)[4] )
 	matrix[0][2] = 2.0 * quaternion[0] * quaternion[2] + 2.0 * quaternion[3] * quaternion[1];
 	matrix[1][2] = 2.0 * quaternion[1] * quaternion[2] - 2.0 * quaternion[3] * quaternion[0];
 	matrix[2][2] = 1.0 - 2.0 * quaternion[0] * quaternion[0] - 2.0 * quaternion[1] * quaternion[1];
+#endif
 }
 
 /*
@@ -27,6 +27,12 @@
 
 #define FDotProduct( a, b ) (fabs((a[0])*(b[0])) + fabs((a[1])*(b[1])) + fabs((a[2])*(b[2])))
 
+// SSE2 kernels perform the same operations in the same order as the scalar code,
+// so both produce identical bone transforms
+#if defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) || defined( __SSE2__ )
+#define STUDIO_SSE2
+#endif
+
 void	AngleMatrix (const float *angles, float (*matrix)[4] );
 int		VectorCompare (const float *v1, const float *v2);
 void	CrossProduct (const float *v1, const float *v2, float *cross);
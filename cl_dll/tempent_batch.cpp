@@ -0,0 +1,99 @@
+// tempent_batch.cpp
+// batched motion of temporary entities
+
+#include "hud.h"
+#include "cl_util.h"
+#include "const.h"
+#include "r_efx.h"
+
+#include "tempent_batch.h"
+
+#if defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) || defined( __SSE2__ )
+#define TEMPENT_SSE2
+#include <emmintrin.h>
+#endif
+
+/*
+====================
+Clear
+
+Arrays keep their capacity, so a busy frame doesn't allocate again
+====================
+*/
+void CTempEntBatch::Clear( void )
+{
+	m_rgTemps.clear();
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		m_rgOrigin[i].clear();
+		m_rgVelocity[i].clear();
+	}
+}
+
+/*
+====================
+Add
+
+baseline.origin holds the velocity of a tempent
+====================
+*/
+void CTempEntBatch::Add( TEMPENTITY *pTemp )
+{
+	m_rgTemps.push_back( pTemp );
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		m_rgOrigin[i].push_back( pTemp->entity.origin[i] );
+		m_rgVelocity[i].push_back( pTemp->entity.baseline.origin[i] );
+	}
+}
+
+/*
+====================
+Integrate
+
+Scalar code promotes to double because frametime is double, the SIMD path
+does the same two lanes at a time so results don't change
+====================
+*/
+void CTempEntBatch::Integrate( double frametime )
+{
+	int count = Count();
+
+	for ( int axis = 0; axis < 3; axis++ )
+	{
+		float *origin = m_rgOrigin[axis].data();
+		const float *velocity = m_rgVelocity[axis].data();
+		int i = 0;
+
+#if defined( TEMPENT_SSE2 )
+		__m128d time = _mm_set1_pd( frametime );
+
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			__m128 o = _mm_loadu_ps( origin + i );
+			__m128 v = _mm_loadu_ps( velocity + i );
+
+			__m128d lo = _mm_add_pd( _mm_cvtps_pd( o ), _mm_mul_pd( _mm_cvtps_pd( v ), time ) );
+			__m128d hi = _mm_add_pd( _mm_cvtps_pd( _mm_movehl_ps( o, o ) ), _mm_mul_pd( _mm_cvtps_pd( _mm_movehl_ps( v, v ) ), time ) );
+
+			_mm_storeu_ps( origin + i, _mm_movelh_ps( _mm_cvtpd_ps( lo ), _mm_cvtpd_ps( hi ) ) );
+		}
+#endif
+
+		for ( ; i < count; i++ )
+		{
+			origin[i] += velocity[i] * frametime;
+		}
+	}
+
+	for ( int i = 0; i < count; i++ )
+	{
+		TEMPENTITY *pTemp = m_rgTemps[i];
+
+		pTemp->entity.origin[0] = m_rgOrigin[0][i];
+		pTemp->entity.origin[1] = m_rgOrigin[1][i];
+		pTemp->entity.origin[2] = m_rgOrigin[2][i];
+	}
+}
@@ -0,0 +1,35 @@
+#if !defined ( TEMPENT_BATCH_H )
+#define TEMPENT_BATCH_H
+#if defined( _WIN32 )
+#pragma once
+#endif
+
+#include <vector>
+
+/*
+====================
+CTempEntBatch
+
+Tempents which simply move along their velocity this frame. Origins and velocities
+are gathered into separate arrays so they can be integrated several at a time,
+then written back to the engine's tempents.
+====================
+*/
+class CTempEntBatch
+{
+public:
+	void Clear( void );
+	void Add( TEMPENTITY *pTemp );
+
+	// origin += velocity * frametime, same rounding as the scalar code
+	void Integrate( double frametime );
+
+	int Count( void ) const { return (int)m_rgTemps.size(); }
+
+private:
+	std::vector<TEMPENTITY *>	m_rgTemps;
+	std::vector<float>			m_rgOrigin[3];
+	std::vector<float>			m_rgVelocity[3];
+};
+
+#endif // TEMPENT_BATCH_H
@@ -30,6 +30,8 @@ void CHudTimer::Reset( void )
 	paused = false;
 	blinked = false;
 	time = 0.0f;
+	timeRate = 0.0f;
+	timeReceived = 0.0f;
 	title = "";
 
 	yOffset = 0;
@@ -65,7 +67,8 @@ int CHudTimer::Draw( float flTime )
 			nextTimerBlinkTime = gEngfuncs.GetAbsoluteTime() + TIMER_PAUSED_BLINK_TIME;
 		}
 	}
-	gHUD.DrawFormattedTime( time, x - formattedTimeSpriteWidth, y, r, g, b );
+	float currentTime = time + timeRate * ( flTime - timeReceived );
+	gHUD.DrawFormattedTime( currentTime, x - formattedTimeSpriteWidth, y, r, g, b );
 
 	return 1;
 }
@@ -75,6 +78,8 @@ int CHudTimer::MsgFunc_TimerValue( const char *pszName, int iSize, void *pbuf )
 	BEGIN_READ(pbuf, iSize);
 	title = READ_STRING();
 	time = READ_FLOAT();
+	timeRate = READ_FLOAT();
+	timeReceived = gEngfuncs.GetClientTime();
 	yOffset = READ_LONG();
 
 	m_iFlags |= HUD_ACTIVE;
@@ -69,6 +69,11 @@ public:
 		int					m_iAudibleList; // first index of a linked list of sounds that the monster can hear.
 		int					m_afSoundTypes;
 
+		// the sounds heard at the last Listen. The m_iNextAudible links are shared by every
+		// monster, so PBestSound and PBestScent look here until this monster listens again.
+		int					m_rgiAudibleSounds[ MAX_AUDIBLE_SOUNDS ];
+		int					m_cAudibleSounds;
+
 		Vector				m_vecLastPosition;// monster sometimes wants to return to where it started after an operation.
 
 		int					m_iHintNode; // this is the hint node that the monster is moving towards or performing active idle on.
@@ -127,6 +132,7 @@ public:
 	virtual void Look ( int iDistance );// basic sight function for monsters
 	virtual void RunAI ( void );// core ai function!	
 	void Listen ( void );
+	void KeepAudibleSound ( int iSound );
 
 	virtual BOOL	IsAlive( void ) { return (pev->deadflag != DEAD_DEAD); }
 	virtual BOOL	ShouldFadeOnDeath( void );
@@ -21,6 +21,7 @@
 #include	"decals.h"
 #include	"gamerules.h"
 #include	"game.h"
+#include	"server_profile.h"
 #include	"gameplay_mod.h"
 #include	"cgm_gamerules.h"
 
@@ -98,6 +99,13 @@ static DLL_FUNCTIONS gFunctionTable =
 	AllowLagCompensation,		//pfnAllowLagCompensation
 };
 
+NEW_DLL_FUNCTIONS gNewDLLFunctions =
+{
+	NULL,						//pfnOnFreeEntPrivateData
+	GameDLLShutdown,			//pfnGameShutdown
+	NULL,						//pfnShouldCollide
+};
+
 static void SetObjectCollisionBox( entvars_t *pev );
 
 extern "C" {
@@ -126,6 +134,18 @@ int GetEntityAPI2( DLL_FUNCTIONS *pFunctionTable, int *interfaceVersion )
 	return TRUE;
 }
 
+int GetNewDLLFunctions( NEW_DLL_FUNCTIONS *pFunctionTable, int *interfaceVersion )
+{
+	if ( !pFunctionTable || *interfaceVersion != NEW_DLL_FUNCTIONS_VERSION )
+	{
+		*interfaceVersion = NEW_DLL_FUNCTIONS_VERSION;
+		return FALSE;
+	}
+
+	memcpy( pFunctionTable, &gNewDLLFunctions, sizeof( NEW_DLL_FUNCTIONS ) );
+	return TRUE;
+}
+
 }
 
 
@@ -211,6 +231,8 @@ void DispatchTouch( edict_t *pentTouched, edict_t *pentOther )
 	if ( gTouchDisabled )
 		return;
 
+	CServerProfileScope profile( PROFILE_TOUCH );
+
 	CBaseEntity *pEntity = (CBaseEntity *)GET_PRIVATE(pentTouched);
 	CBaseEntity *pOther = (CBaseEntity *)GET_PRIVATE( pentOther );
 
@@ -230,6 +252,8 @@ void DispatchUse( edict_t *pentUsed, edict_t *pentOther )
 
 void DispatchThink( edict_t *pent )
 {
+	CServerProfileScope profile( PROFILE_THINK, pent );
+
 	CBaseEntity *pEntity = (CBaseEntity *)GET_PRIVATE(pent);
 	if (pEntity)
 	{
@@ -369,6 +393,9 @@ int DispatchRestore( edict_t *pent, SAVERESTOREDATA *pSaveData, int globalEntity
 		// Again, could be deleted, get the pointer again.
 		pEntity = (CBaseEntity *)GET_PRIVATE(pent);
 
+		// Restored names, or the names of the global entity overlaid
+		UTIL_EntityNameChanged( pent );
+
 #if 0
 		if ( pEntity && pEntity->pev->globalname && globalEntity ) 
 		{
@@ -70,6 +70,7 @@ CBaseEntity
 
 extern "C" CBASE_DLLEXPORT int GetEntityAPI( DLL_FUNCTIONS *pFunctionTable, int interfaceVersion );
 extern "C" CBASE_DLLEXPORT int GetEntityAPI2( DLL_FUNCTIONS *pFunctionTable, int *interfaceVersion );
+extern "C" CBASE_DLLEXPORT int GetNewDLLFunctions( NEW_DLL_FUNCTIONS *pFunctionTable, int *interfaceVersion );
 
 extern int DispatchSpawn( edict_t *pent );
 extern void DispatchKeyValue( edict_t *pentKeyvalue, KeyValueData *pkvd );
@@ -232,6 +233,8 @@ public:
 	// allow engine to allocate instance data
     void *operator new( size_t stAllocateBlock, entvars_t *pev )
 	{
+		// Names aren't set yet, the entity is indexed on the next lookup
+		UTIL_EntityNameChanged( ENT(pev) );
 		return (void *)ALLOC_PRIVATE(ENT(pev), stAllocateBlock);
 	};
 
@@ -584,6 +587,7 @@ public:
 
 #define	ROUTE_SIZE			8 // how many waypoints a monster can store at one time
 #define MAX_OLD_ENEMIES		4 // how many old enemies to remember
+#define MAX_AUDIBLE_SOUNDS	64 // how many heard sounds a monster keeps between listens
 
 #define	bits_CAP_DUCK			( 1 << 0 )// crouch
 #define	bits_CAP_JUMP			( 1 << 1 )// jump/leap
@@ -105,7 +105,7 @@ CCustomGameModeRules::CCustomGameModeRules( CONFIG_TYPE configType ) : config( c
 		gmsgCountOffse = REG_USER_MSG( "CountOffse", 4 );
 
 		gmsgScoreDeact = REG_USER_MSG( "ScoreDeact", 0 );
-		gmsgScoreValue = REG_USER_MSG( "ScoreValue", 16 );
+		gmsgScoreValue = REG_USER_MSG( "ScoreValue", 20 );
 
 		gmsgCLabelVal = REG_USER_MSG( "CLabelVal", -1 );
 		gmsgCLabelGMod = REG_USER_MSG( "CLabelGMod", -1 );
@@ -131,6 +131,10 @@ CCustomGameModeRules::CCustomGameModeRules( CONFIG_TYPE configType ) : config( c
 	musicSwitchDelay = 0.0f;
 
 	maxYOffset = -1;
+
+	ForceHUDMessages();
+	kerotanCounterMapName = 0;
+	kerotanCounterHookedCount = -1;
 
 	for ( const auto &spawner : config.entityRandomSpawners ) {
 		if ( !spawner.spawnOnce ) {
@@ -288,9 +292,17 @@ void CCustomGameModeRules::PlayerSpawn( CBasePlayer *pPlayer )
 	CHalfLifeRules::PlayerSpawn( pPlayer );
 
 	gameplayModsData.activeGameMode = GAME_MODE_CUSTOM;
-	gameplayModsData.gungameSeed = aux::rand::uniformInt( 0, 10000 );
-	gameplayModsData.randomSpawnerSeed = aux::rand::uniformInt( 0, 10000 );
-	gameplayModsData.musicPlaylistSeed = aux::rand::uniformInt( 0, 10000 );
+
+	// Fixed seed makes runs repeatable, replays set it
+	if ( int seed = ( int ) cgm_seed.value ) {
+		gameplayModsData.gungameSeed = seed;
+		gameplayModsData.randomSpawnerSeed = seed + 1;
+		gameplayModsData.musicPlaylistSeed = seed + 2;
+	} else {
+		gameplayModsData.gungameSeed = aux::rand::uniformInt( 0, 10000 );
+		gameplayModsData.randomSpawnerSeed = aux::rand::uniformInt( 0, 10000 );
+		gameplayModsData.musicPlaylistSeed = aux::rand::uniformInt( 0, 10000 );
+	}
 	for ( auto &condition : config.endConditions ) {
 		condition.activations = 0;
 	}
@@ -1124,79 +1136,166 @@ void CCustomGameModeRules::ParseTwitchMessages() {
 	}
 }
 
+void CCustomGameModeRules::ForceHUDMessages() {
+	hudTimer.sent = false;
+	hudScore.sent = false;
+	hudCountersSent = false;
+	sentHUDCounters.clear();
+}
+
+void CCustomGameModeRules::SetHUDCounter( size_t index, int count, int maxCount, const char *text, int offset ) {
+	if ( index >= hudCounters.size() ) {
+		hudCounters.resize( index + 1 );
+	}
+
+	// Assigning over the previous frame's counter keeps the string's storage
+	HUDCounter &counter = hudCounters[index];
+	counter.count = count;
+	counter.maxCount = maxCount;
+	counter.text = text;
+	counter.offset = offset;
+}
+
 void CCustomGameModeRules::SendHUDMessages( CBasePlayer *pPlayer ) {
 	const int SPACING = 56;
 	int yOffset = 0;
 
+	// Timer and combo decay are extrapolated by the client from the last value, rate and time sent,
+	// so they only go out when the server's value stops following that line
+	const float HUD_EXTRAPOLATION_TOLERANCE = 0.01f;
+
 	if ( gameplayMods::timerShown.isActive() ) {
-		MESSAGE_BEGIN( MSG_ONE, gmsgTimerValue, NULL, pPlayer->pev );
-			WRITE_STRING(
-				gameplayMods::timerShownReal.isActive() ? "REAL TIME" :
-				gameplayMods::timeRestriction.isActive() ? "TIME LEFT" :
-				"TIME"
-			);
-			WRITE_FLOAT( gameplayMods::timerShownReal.isActive() ? gameplayModsData.realTime : gameplayModsData.time );
-			WRITE_LONG( yOffset );
-		MESSAGE_END();
+		const char *title =
+			gameplayMods::timerShownReal.isActive() ? "REAL TIME" :
+			gameplayMods::timeRestriction.isActive() ? "TIME LEFT" :
+			"TIME";
+		float value = gameplayMods::timerShownReal.isActive() ? gameplayModsData.realTime : gameplayModsData.time;
+
+		// Same as how PlayerThink advances the timer
+		float rate = 0.0f;
+		if ( !gameplayModsData.timerPaused && pPlayer->pev->deadflag == DEAD_NO ) {
+			if ( gameplayMods::timerShownReal.isActive() ) {
+				rate = pPlayer->desiredTimeScale > 0.0f ? 1.0f / pPlayer->desiredTimeScale : 0.0f;
+			} else {
+				rate = gameplayMods::timeRestriction.isActive() ? -1.0f : 1.0f;
+			}
+		}
+
+		float extrapolated = hudTimer.value + hudTimer.rate * ( gpGlobals->time - hudTimer.time );
+
+		if (
+			!hudTimer.sent ||
+			hudTimer.title != title ||
+			hudTimer.rate != rate ||
+			hudTimer.yOffset != yOffset ||
+			fabs( extrapolated - value ) > HUD_EXTRAPOLATION_TOLERANCE
+		) {
+			MESSAGE_BEGIN( MSG_ONE, gmsgTimerValue, NULL, pPlayer->pev );
+				WRITE_STRING( title );
+				WRITE_FLOAT( value );
+				WRITE_FLOAT( rate );
+				WRITE_LONG( yOffset );
+			MESSAGE_END();
+
+			hudTimer.sent = true;
+			hudTimer.title = title;
+			hudTimer.value = value;
+			hudTimer.rate = rate;
+			hudTimer.time = gpGlobals->time;
+			hudTimer.yOffset = yOffset;
+		}
 
 		yOffset += SPACING;
 	}
 
 	if ( gameplayMods::scoreAttack.isActive() ) {
-		MESSAGE_BEGIN( MSG_ONE, gmsgScoreValue, NULL, pPlayer->pev );
-			WRITE_LONG( gameplayModsData.score );
-			WRITE_LONG( gameplayModsData.comboMultiplier );
-			WRITE_FLOAT( gameplayModsData.comboMultiplierReset );
-			WRITE_LONG( yOffset );
-		MESSAGE_END();
+		float rate = pPlayer->desiredTimeScale > 0.0f ? 1.0f / pPlayer->desiredTimeScale : 0.0f;
+		float extrapolated = max( 0.0f, hudScore.comboMultiplierReset - hudScore.rate * ( gpGlobals->time - hudScore.time ) );
+
+		// Decay is only drawn while there's a multiplier
+		bool resetDiverged =
+			gameplayModsData.comboMultiplier > 1 &&
+			( hudScore.rate != rate || fabs( extrapolated - gameplayModsData.comboMultiplierReset ) > HUD_EXTRAPOLATION_TOLERANCE );
+
+		if (
+			!hudScore.sent ||
+			hudScore.score != gameplayModsData.score ||
+			hudScore.comboMultiplier != gameplayModsData.comboMultiplier ||
+			hudScore.yOffset != yOffset ||
+			resetDiverged
+		) {
+			MESSAGE_BEGIN( MSG_ONE, gmsgScoreValue, NULL, pPlayer->pev );
+				WRITE_LONG( gameplayModsData.score );
+				WRITE_LONG( gameplayModsData.comboMultiplier );
+				WRITE_FLOAT( gameplayModsData.comboMultiplierReset );
+				WRITE_FLOAT( rate );
+				WRITE_LONG( yOffset );
+			MESSAGE_END();
+
+			hudScore.sent = true;
+			hudScore.score = gameplayModsData.score;
+			hudScore.comboMultiplier = gameplayModsData.comboMultiplier;
+			hudScore.comboMultiplierReset = gameplayModsData.comboMultiplierReset;
+			hudScore.rate = rate;
+			hudScore.time = gpGlobals->time;
+			hudScore.yOffset = yOffset;
+		}
 
 		yOffset += SPACING;
 	}
 
-	struct CounterData {
-		int count;
-		int maxCount;
-		std::string text;
-		int offset;
-	};
-
-	std::vector<CounterData> counterData;
+	size_t counterCount = 0;
 	for ( auto &endCondition : config.endConditions ) {
-		counterData.push_back( {
+		SetHUDCounter(
+			counterCount++,
 			endCondition.activations,
 			endCondition.activationsRequired,
-			endCondition.objective,
+			endCondition.objective.c_str(),
 			endCondition.activationsRequired > 1 ? SPACING : SPACING - 34
-		} );
+		);
 	}
 	if ( gameplayMods::kerotanDetector.isActive() ) {
-		auto chapterMaps = pPlayer->GetCurrentChapterMapNames();
-		counterData.push_back( {
-			pPlayer->GetAmountOfKerotansInCurrentChapter(),
-			( int ) chapterMaps.second.size(),
-			chapterMaps.first.c_str(),
+		// Chapter and its kerotans only change with the map or when a kerotan is found
+		if (
+			kerotanCounterMapName != gpGlobals->mapname ||
+			kerotanCounterHookedCount != pPlayer->hookedMapsWithKerotansCount
+		) {
+			auto chapterMaps = pPlayer->GetCurrentChapterMapNames();
+			kerotanCounterMapName = gpGlobals->mapname;
+			kerotanCounterHookedCount = pPlayer->hookedMapsWithKerotansCount;
+			kerotanCounterCount = pPlayer->GetAmountOfKerotansInCurrentChapter();
+			kerotanCounterMaxCount = chapterMaps.second.size();
+			kerotanCounterTitle = chapterMaps.first;
+		}
+
+		SetHUDCounter(
+			counterCount++,
+			kerotanCounterCount,
+			kerotanCounterMaxCount,
+			kerotanCounterTitle.c_str(),
 			SPACING
-		} );
+		);
 	}
 	
 	if ( auto gungame = gameplayMods::gungame.isActive<GunGameInfo>() ) {
-		auto chapterMaps = pPlayer->GetCurrentChapterMapNames();
 		if ( gungame->killsRequired ) {
-			counterData.push_back( {
+			SetHUDCounter(
+				counterCount++,
 				gungame->killsRequired > 1 ? gungame->killsRequired - gameplayModsData.gungameKillsLeft : -1,
 				gungame->killsRequired > 1 ? gungame->killsRequired : -1,
 				gungame->killsRequired > 1 ? "KILLS UNTIL NEXT WEAPON" : "KILL TO GET THE NEXT WEAPON",
 				SPACING
-			} );
+			);
 		}
 		
 		if ( gungame->changeTime ) {
-			counterData.push_back( {
+			SetHUDCounter(
+				counterCount++,
 				( int ) std::ceil( gameplayModsData.gungameTimeLeftUntilNextWeapon ),
 				-1,
 				"TIME LEFT UNTIL NEXT WEAPON",
 				SPACING
-			} );
+			);
 		}
 	}
 	if ( gameplayMods::timescaleOnDamage.isActive() ) {
@@ -1216,36 +1315,61 @@ void CCustomGameModeRules::SendHUDMessages( CBasePlayer *pPlayer ) {
 		) {
 			auto timescale_multiplier = *gameplayMods::timescale.isActive<float>() + gameplayModsData.timescaleAdditive;
 
-			counterData.push_back( {
+			char timescaleText[32];
+			sprintf_s( timescaleText, "TIMESCALE: %.0f%%", timescale_multiplier * 100 );
+
+			SetHUDCounter(
+				counterCount++,
 				-1,
 				-1,
-				fmt::sprintf( "TIMESCALE: %.0f%%", timescale_multiplier * 100 ),
+				timescaleText,
 				SPACING - 34
-			} );
+			);
 		}
 	}
 
 	int conditionsHeight = 0;
 
-	MESSAGE_BEGIN( MSG_ONE, gmsgCountLen, NULL, pPlayer->pev );
-		WRITE_SHORT( counterData.size() );
-	MESSAGE_END();
+	if ( !hudCountersSent || sentHUDCounters.size() != counterCount ) {
+		MESSAGE_BEGIN( MSG_ONE, gmsgCountLen, NULL, pPlayer->pev );
+			WRITE_SHORT( counterCount );
+		MESSAGE_END();
 
-	for ( size_t i = 0 ; i < counterData.size() ; i++ ) {
-		auto &counter = counterData.at( i );
-		MESSAGE_BEGIN( MSG_ONE, gmsgCountValue, NULL, pPlayer->pev );
-			WRITE_SHORT( i );
-			WRITE_LONG( counter.count );
-			WRITE_LONG( counter.maxCount );
-			WRITE_STRING( counter.text.c_str() );
-		MESSAGE_END();
+		sentHUDCounters.resize( counterCount );
+	}
+
+	for ( size_t i = 0 ; i < counterCount ; i++ ) {
+		auto &counter = hudCounters.at( i );
+		auto &sentCounter = sentHUDCounters.at( i );
+
+		if (
+			!hudCountersSent ||
+			sentCounter.count != counter.count ||
+			sentCounter.maxCount != counter.maxCount ||
+			sentCounter.text != counter.text
+		) {
+			MESSAGE_BEGIN( MSG_ONE, gmsgCountValue, NULL, pPlayer->pev );
+				WRITE_SHORT( i );
+				WRITE_LONG( counter.count );
+				WRITE_LONG( counter.maxCount );
+				WRITE_STRING( counter.text.c_str() );
+			MESSAGE_END();
+
+			sentCounter = counter;
+		}
 
 		conditionsHeight += counter.offset;
 	}
 	
-	MESSAGE_BEGIN( MSG_ONE, gmsgCountOffse, NULL, pPlayer->pev );
-		WRITE_LONG( yOffset );
-	MESSAGE_END();
+	if ( !hudCountersSent || sentCounterOffset != yOffset ) {
+		MESSAGE_BEGIN( MSG_ONE, gmsgCountOffse, NULL, pPlayer->pev );
+			WRITE_LONG( yOffset );
+		MESSAGE_END();
+
+		sentCounterOffset = yOffset;
+	}
+
+	hudCountersSent = true;
 
 	yOffset += conditionsHeight;
 	maxYOffset = max( yOffset, maxYOffset );
@@ -1350,6 +1474,7 @@ void CCustomGameModeRules::OnEnd( CBasePlayer *pPlayer ) {
 
 	MESSAGE_BEGIN( MSG_ONE, gmsgTimerDeact, NULL, pPlayer->pev );
 	MESSAGE_END();
+	hudTimer.sent = false;
 
 	MESSAGE_BEGIN( MSG_ONE, gmsgEndTime, NULL, pPlayer->pev );
 		WRITE_STRING( timeRestriction ? "TIME SCORE|PERSONAL BESTS" : "TIME|PERSONAL BESTS" );
@@ -1415,6 +1540,7 @@ void CCustomGameModeRules::OnEnd( CBasePlayer *pPlayer ) {
 	if ( gameplayMods::scoreAttack.isActive() ) {
 		MESSAGE_BEGIN( MSG_ONE, gmsgScoreDeact, NULL, pPlayer->pev );
 		MESSAGE_END();
+		hudScore.sent = false;
 
 		MESSAGE_BEGIN( MSG_ONE, gmsgEndScore, NULL, pPlayer->pev );
 			WRITE_STRING( "SCORE|PERSONAL BEST" );
@@ -1433,6 +1559,17 @@ void CCustomGameModeRules::OnEnd( CBasePlayer *pPlayer ) {
 	}
 }
 
+void CCustomGameModeRules::RecordSplit() {
+	// Intermissions can be triggered by trigger_changelevel itself
+	if ( gameplayModsData.splitsCount > 0 && gameplayModsData.splits[gameplayModsData.splitsCount - 1] == gameplayModsData.time ) {
+		return;
+	}
+
+	if ( gameplayModsData.splitsCount < 64 ) {
+		gameplayModsData.splits[gameplayModsData.splitsCount++] = gameplayModsData.time;
+	}
+}
+
 void CCustomGameModeRules::OnHookedModelIndex( CBasePlayer *pPlayer, CBaseEntity *activator, int modelIndex, const std::string &className, const std::string &targetName, bool firstTime )
 {
 	CHalfLifeRules::OnHookedModelIndex( pPlayer, activator, modelIndex, className, targetName, firstTime );
@@ -1441,8 +1578,13 @@ void CCustomGameModeRules::OnHookedModelIndex( CBasePlayer *pPlayer, CBaseEntity
 		End( pPlayer );
 	}
 
+	if ( firstTime && className == "trigger_changelevel" ) {
+		RecordSplit();
+	}
+
 	for ( const auto &potentialIntermission : config.intermissions ) {
 		if ( potentialIntermission.Fits( modelIndex, className, targetName, firstTime ) ) {
+			RecordSplit();
 			g_latestIntermission = potentialIntermission;
 			CHANGE_LEVEL( ( char * ) g_latestIntermission.entityName.c_str(), NULL );
 			// after that, g_latestIntermission becomes undefined in PlayerSpawn function
@@ -54,6 +54,8 @@ public:
 	void ParseTwitchMessages();
 
 	void SendHUDMessages( CBasePlayer *pPlayer );
+	void ForceHUDMessages();
+	void RecordSplit();
 	void TogglePaynedModels();
 	void ToggleInvisibleEnemies();
 
@@ -77,6 +79,47 @@ public:
 
 protected:
 	virtual void OnEnd( CBasePlayer *pPlayer );
+
+private:
+	// What the client HUD was last told, SendHUDMessages only sends what differs
+	struct HUDTimer {
+		bool sent;
+		const char *title;
+		float value;
+		float rate;
+		float time;
+		int yOffset;
+	} hudTimer;
+
+	struct HUDScore {
+		bool sent;
+		int score;
+		int comboMultiplier;
+		float comboMultiplierReset;
+		float rate;
+		float time;
+		int yOffset;
+	} hudScore;
+
+	struct HUDCounter {
+		int count;
+		int maxCount;
+		std::string text;
+		int offset;
+	};
+
+	std::vector<HUDCounter> hudCounters;
+	std::vector<HUDCounter> sentHUDCounters;
+	bool hudCountersSent;
+	int sentCounterOffset;
+
+	string_t kerotanCounterMapName;
+	int kerotanCounterHookedCount;
+	int kerotanCounterCount;
+	int kerotanCounterMaxCount;
+	std::string kerotanCounterTitle;
+
+	void SetHUDCounter( size_t index, int count, int maxCount, const char *text, int offset );
 };
 
 
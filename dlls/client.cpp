@@ -31,8 +31,11 @@
 #include "spectator.h"
 #include "client.h"
 #include "soundent.h"
+#include "monsters.h"
 #include "gamerules.h"
 #include "game.h"
+#include "precache.h"
+#include "server_profile.h"
 #include "customentity.h"
 #include "weapons.h"
 #include "weaponinfo.h"
@@ -663,6 +666,24 @@ void ClientCommand( edict_t *pEntity )
 			}
 		}
 	}
+	else if ( FStrEq( pcmd, "gameplay_mod_replay_vote" ) ) {
+		// Vote played back by an input replay, applied the way the Twitch vote it was recorded from was.
+		// Replays always run under sv_profile, anything else is refused.
+		if ( CMD_ARGC() < 3 || !g_ServerProfiler.IsActive() ) {
+			return;
+		}
+
+		if ( CCustomGameModeRules *cgm = dynamic_cast< CCustomGameModeRules * >( g_pGameRules ) ) {
+			auto voter = std::string( CMD_ARGV( 1 ) );
+			auto modIndex = std::string( CMD_ARGV( 2 ) );
+
+			if ( CBasePlayer *player = dynamic_cast< CBasePlayer* >( CBasePlayer::Instance( g_engfuncs.pfnPEntityOfEntIndex( 1 ) ) ) ) {
+				if ( gameplayMods::AllowedToVoteOnRandomGameplayMods() ) {
+					cgm->VoteForRandomGameplayMod( player, voter, modIndex );
+				}
+			}
+		}
+	}
 	else if ( FStrEq( pcmd, "psp" ) ) {
 		auto models = ( char ** ) ( STRING( gpGlobals->startspot ) - 0xB0 + 0x32350 );
 
@@ -676,6 +697,14 @@ void ClientCommand( edict_t *pEntity )
 		
 		ALERT( at_notice, "precached %d of 512\n", total );
 	}
+#ifdef _DEBUG
+	else if ( FStrEq( pcmd, "sentence_bench" ) ) {
+		// Stalls the server for as long as it runs
+		if ( UTIL_CheatsAllowed() || ( !IS_DEDICATED_SERVER() && ENTINDEX( pEntity ) == 1 ) ) {
+			SENTENCEG_Benchmark( CMD_ARGC() > 1 ? atoi( CMD_ARGV( 1 ) ) : 100000 );
+		}
+	}
+#endif
 	else if ( g_pGameRules->ClientCommand( GetClassPtr((CBasePlayer *)pev), pcmd ) )
 	{
 		// MenuSelect returns true only if the command is properly handled,  so don't print a warning
@@ -813,6 +842,9 @@ void ServerActivate( edict_t *pEdictList, int edictCount, int clientMax )
 
 	// Link user messages here to make sure first client can get them...
 	LinkUserMessages();
+
+	// No more precaching from here on
+	UTIL_FinishPrecache();
 }
 
 
@@ -828,6 +860,7 @@ void PlayerPreThink( edict_t *pEntity )
 	entvars_t *pev = &pEntity->v;
 	CBasePlayer *pPlayer = (CBasePlayer *)GET_PRIVATE(pEntity);
 
+	CServerProfileScope profile( PROFILE_PRETHINK );
 	if (pPlayer)
 		pPlayer->PreThink( );
 }
@@ -844,6 +877,7 @@ void PlayerPostThink( edict_t *pEntity )
 	entvars_t *pev = &pEntity->v;
 	CBasePlayer *pPlayer = (CBasePlayer *)GET_PRIVATE(pEntity);
 
+	CServerProfileScope profile( PROFILE_POSTTHINK );
 	if (pPlayer)
 		pPlayer->PostThink( );
 }
@@ -870,6 +904,12 @@ void ParmsChangeLevel( void )
 //
 void StartFrame( void )
 {
+	g_ServerProfiler.StartFrame();
+	CServerProfileScope profile( PROFILE_STARTFRAME );
+
+	// renames nobody reported are picked up here
+	UTIL_RevalidateEntityIndex();
+
 	if ( g_pGameRules )
 		g_pGameRules->Think();
 
@@ -878,6 +918,16 @@ void StartFrame( void )
 
 	gpGlobals->teamplay = teamplay.value;
 	g_ulFrameCount++;
+
+	int lookups, scanned;
+	UTIL_EntityIndexStats( &lookups, &scanned );
+	if ( entindex_debug.value && lookups )
+		ALERT( at_console, "Entity index: %d lookups, %d edicts checked\n", lookups, scanned );
+
+	int traces, tracesSaved;
+	VisibilityCacheStats( &traces, &tracesSaved );
+	if ( ai_vis_cache.value >= 2 && ( traces || tracesSaved ) )
+		ALERT( at_console, "Monster sight: %d traces, %d saved\n", traces, tracesSaved );
 }
 
 
@@ -1237,6 +1287,8 @@ int AddToFullPack( struct entity_state_s *state, int e, edict_t *ent, edict_t *h
 {
 	int					i;
 
+	CServerProfileScope profile( PROFILE_ADDTOFULLPACK );
+
 	// don't send if flagged for NODRAW and it's not the host getting the message
 	if ( ( ent->v.effects & EF_NODRAW ) &&
 		 ( ent != host ) )
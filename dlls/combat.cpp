@@ -32,6 +32,7 @@
 #include "player.h"
 #include "gamerules.h"
 #include "cgm_gamerules.h"
+#include "game.h"
 
 extern DLL_GLOBAL Vector		g_vecAttackDir;
 extern DLL_GLOBAL int			g_iSkillLevel;
@@ -1415,13 +1416,116 @@ BOOL CBaseMonster :: FInViewCone ( Vector *pOrigin )
 	}
 }
 
+//=========================================================
+// Line of sight cache
+//
+// Eye to eye traces between the same two entities are kept
+// for the rest of the frame, as long as neither eye moved.
+// Look, CheckAttack and the schedules all ask the same
+// questions several times a frame.
+//=========================================================
+#define VISIBILITY_CACHE_SIZE	1024	// power of two
+
+typedef struct
+{
+	int		looker;
+	int		target;
+	float	time;
+	Vector	vecLooker;
+	Vector	vecTarget;
+	BOOL	visible;
+} visibilityentry_t;
+
+static visibilityentry_t	g_VisibilityCache[VISIBILITY_CACHE_SIZE];
+static int					g_iVisibilityTraces = 0;
+static int					g_iVisibilityTracesSaved = 0;
+
+static BOOL FLineOfSight( edict_t *pentLooker, const Vector &vecLooker, edict_t *pentTarget, const Vector &vecTarget )
+{
+	TraceResult tr;
+
+	if ( !ai_vis_cache.value )
+	{
+		UTIL_TraceLine( vecLooker, vecTarget, ignore_monsters, ignore_glass, pentLooker, &tr );
+		return tr.flFraction == 1.0;
+	}
+
+	int looker = ENTINDEX( pentLooker );
+	int target = ENTINDEX( pentTarget );
+	visibilityentry_t *pEntry = &g_VisibilityCache[( looker * 31 + target ) & ( VISIBILITY_CACHE_SIZE - 1 )];
+
+	if ( pEntry->looker == looker && pEntry->target == target && pEntry->time == gpGlobals->time &&
+		pEntry->vecLooker == vecLooker && pEntry->vecTarget == vecTarget )
+	{
+		g_iVisibilityTracesSaved++;
+		return pEntry->visible;
+	}
+
+	UTIL_TraceLine( vecLooker, vecTarget, ignore_monsters, ignore_glass, pentLooker, &tr );
+	g_iVisibilityTraces++;
+
+	pEntry->looker		= looker;
+	pEntry->target		= target;
+	pEntry->time		= gpGlobals->time;
+	pEntry->vecLooker	= vecLooker;
+	pEntry->vecTarget	= vecTarget;
+	pEntry->visible		= tr.flFraction == 1.0;
+
+	return pEntry->visible;
+}
+
+//=========================================================
+// FVisibleInPVS - FALSE if the target's eyes are outside
+// the PVS of the looker's eyes, no trace could reach them.
+// *ppPVS starts out NULL and keeps the looker's PVS for
+// the next candidate.
+//=========================================================
+BOOL FVisibleInPVS( CBaseEntity *pLooker, CBaseEntity *pTarget, unsigned char **ppPVS )
+{
+	if ( !ai_vis_cache.value )
+		return TRUE;
+
+	// The engine checks the leafs of the target's box, so it only
+	// tells something about eyes inside that box
+	Vector vecTarget = pTarget->EyePosition();
+	const Vector &absmin = pTarget->pev->absmin;
+	const Vector &absmax = pTarget->pev->absmax;
+
+	if ( vecTarget.x < absmin.x || vecTarget.y < absmin.y || vecTarget.z < absmin.z ||
+		vecTarget.x > absmax.x || vecTarget.y > absmax.y || vecTarget.z > absmax.z )
+		return TRUE;
+
+	if ( !*ppPVS )
+	{
+		Vector vecLooker = pLooker->pev->origin + pLooker->pev->view_ofs;
+		*ppPVS = ENGINE_SET_PVS( (float *)&vecLooker );
+	}
+
+	if ( ENGINE_CHECK_VISIBILITY( pTarget->edict(), *ppPVS ) )
+		return TRUE;
+
+	g_iVisibilityTracesSaved++;
+	return FALSE;
+}
+
+//=========================================================
+// Traces made and saved since the last call
+//=========================================================
+void VisibilityCacheStats( int *pTraces, int *pSaved )
+{
+	*pTraces = g_iVisibilityTraces;
+	*pSaved = g_iVisibilityTracesSaved;
+
+	g_iVisibilityTraces = 0;
+	g_iVisibilityTracesSaved = 0;
+}
+
 //=========================================================
 // FVisible - returns true if a line can be traced from
 // the caller's eyes to the target
 //=========================================================
 BOOL CBaseEntity :: FVisible ( CBaseEntity *pEntity )
 {
-	TraceResult tr;
 	Vector		vecLookerOrigin;
 	Vector		vecTargetOrigin;
 	
@@ -1436,16 +1540,7 @@ BOOL CBaseEntity :: FVisible ( CBaseEntity *pEntity )
 	vecLookerOrigin = pev->origin + pev->view_ofs;//look through the caller's 'eyes'
 	vecTargetOrigin = pEntity->EyePosition();
 
-	UTIL_TraceLine(vecLookerOrigin, vecTargetOrigin, ignore_monsters, ignore_glass, ENT(pev)/*pentIgnore*/, &tr);
-	
-	if (tr.flFraction != 1.0)
-	{
-		return FALSE;// Line of sight is not established
-	}
-	else
-	{
-		return TRUE;// line of sight is valid.
-	}
+	return FLineOfSight( ENT(pev), vecLookerOrigin, pEntity->edict(), vecTargetOrigin );
 }
 
 //=========================================================
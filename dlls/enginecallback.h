@@ -23,9 +23,19 @@ extern enginefuncs_t g_engfuncs;
 
 // The actual engine callbacks
 #define GETPLAYERUSERID (*g_engfuncs.pfnGetPlayerUserId)
+#if !defined( CLIENT_DLL )
+// Server precaches go through the registry in precache.cpp, which skips repeats
+int UTIL_PrecacheModel( const char *s );
+int UTIL_PrecacheSound( const char *s );
+int UTIL_PrecacheGeneric( const char *s );
+#define PRECACHE_MODEL	UTIL_PrecacheModel
+#define PRECACHE_SOUND	UTIL_PrecacheSound
+#define PRECACHE_GENERIC	UTIL_PrecacheGeneric
+#else
 #define PRECACHE_MODEL	(*g_engfuncs.pfnPrecacheModel)
 #define PRECACHE_SOUND	(*g_engfuncs.pfnPrecacheSound)
 #define PRECACHE_GENERIC	(*g_engfuncs.pfnPrecacheGeneric)
+#endif
 #define SET_MODEL		(*g_engfuncs.pfnSetModel)
 #define MODEL_INDEX		(*g_engfuncs.pfnModelIndex)
 #define MODEL_FRAMES	(*g_engfuncs.pfnModelFrames)
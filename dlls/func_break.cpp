@@ -783,6 +783,7 @@ void CBreakable::Die( void )
 
 	// Don't fire something that could fire myself
 	pev->targetname = 0;
+	UTIL_EntityNameChanged( edict() );
 
 	pev->solid = SOLID_NOT;
 	// Fire targets on break
@@ -22,8 +22,15 @@
 #include "fs_aux.h"
 #include "../twitch/twitch.h"
 #include "../fmt/printf.h"
+#include "custom_gamemode_record_store.h"
 
 cvar_t	displaysoundlist = {"displaysoundlist","0"};
+cvar_t	entindex_debug = {"entindex_debug","0"};	// 1 prints entity name index work per frame, 2 checks each lookup against a full scan
+cvar_t	ai_vis_cache = {"ai_vis_cache","1"};		// 0 traces every monster sight check, 2 also prints traces made and saved per frame
+cvar_t	sv_profile = {"sv_profile","0"};			// times the game DLL over this many server frames, then reports and writes profile/<map>.csv
+cvar_t	sv_profile_name = {"sv_profile_name",""};	// name of the profile CSV instead of the map name
+cvar_t	cgm_seed = {"cgm_seed","0"};				// fixed seed for gungame, random spawners and music of custom game modes, 0 picks one at random
+cvar_t	precache_manifest = {"precache_manifest","0"};	// 1 precaches from maps/precache manifests and reports use against limits, 2 also builds manifests for all maps starting from the current one
 
 // multiplayer server rules
 cvar_t	fragsleft	= {"mp_fragsleft","0", FCVAR_SERVER | FCVAR_UNLOGGED };	  // Don't spam console/log files/users with this changing
@@ -583,6 +590,12 @@ void GameDLLInit( void )
 	}
 
 	CVAR_REGISTER (&displaysoundlist);
+	CVAR_REGISTER (&entindex_debug);
+	CVAR_REGISTER (&ai_vis_cache);
+	CVAR_REGISTER (&precache_manifest);
+	CVAR_REGISTER (&sv_profile);
+	CVAR_REGISTER (&sv_profile_name);
+	CVAR_REGISTER (&cgm_seed);
 	CVAR_REGISTER( &allow_spectators );
 
 	CVAR_REGISTER (&teamplay);
@@ -1010,3 +1023,10 @@ void GameDLLInit( void )
 	SERVER_COMMAND( "exec skill.cfg\n" );
 }
 
+// Called once when the engine shuts down, before the DLL is unloaded
+void GameDLLShutdown( void )
+{
+	// Records are saved on the writer thread, wait for the last ones to reach the disk
+	CustomGameModeRecordStore::Get().Shutdown();
+}
+
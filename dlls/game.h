@@ -17,9 +17,16 @@
 #define GAME_H
 
 extern void GameDLLInit( void );
+extern void GameDLLShutdown( void );
 
 
 extern cvar_t	displaysoundlist;
+extern cvar_t	entindex_debug;
+extern cvar_t	ai_vis_cache;
+extern cvar_t	precache_manifest;
+extern cvar_t	sv_profile;
+extern cvar_t	sv_profile_name;
+extern cvar_t	cgm_seed;
 
 // multiplayer server rules
 extern cvar_t	teamplay;
@@ -81,6 +81,7 @@ void CWorldItem::Spawn( void )
 		pEntity->pev->target = pev->target;
 		pEntity->pev->targetname = pev->targetname;
 		pEntity->pev->spawnflags = pev->spawnflags;
+		UTIL_EntityNameChanged( pEntity->edict() );
 	}
 
 	REMOVE_ENTITY(edict());
@@ -74,6 +74,7 @@ int CKerotan::TakeDamage( entvars_t * pevInflictor, entvars_t * pevAttacker, flo
 		if ( CHalfLifeRules *rules = dynamic_cast< CHalfLifeRules * >( g_pGameRules ) ) {
 			if ( std::string( STRING( pev->targetname ) ).empty() ) {
 				pev->targetname = MAKE_STRING( "kerotan_found" );
+				UTIL_EntityNameChanged( edict() );
 			}
 			rules->HookModelIndex( edict() );
 		}
@@ -42,6 +42,7 @@ public:
 	void EXPORT MakerThink ( void );
 	void DeathNotice ( entvars_t *pevChild );// monster maker children use this to tell the monster maker that they have died.
 	void MakeMonster( void );
+	BOOL FBlockerInBox( const Vector &mins, const Vector &maxs );
 
 	virtual int		Save( CSave &save );
 	virtual int		Restore( CRestore &restore );
@@ -57,9 +58,15 @@ public:
 	int	 m_iMaxLiveChildren;// max number of monsters that this maker may have out at one time.
 
 	float m_flGround; // z coord of the ground under me, used to make sure no monsters are under the maker when it drops a new child
+	BOOL m_fGroundSet;// m_flGround has been traced
 
 	BOOL m_fActive;
 	BOOL m_fFadeChildren;// should we make the children fadeout?
+
+	BOOL m_fSleeping;// stopped thinking at the live children limit, DeathNotice wakes us
+	float m_flSleepTime;// time of the think that went to sleep
+
+	EHANDLE m_hBlocker;// last monster or client found under the maker
 };
 
 LINK_ENTITY_TO_CLASS( monstermaker, CMonsterMaker );
@@ -73,6 +80,9 @@ TYPEDESCRIPTION	CMonsterMaker::m_SaveData[] =
 	DEFINE_FIELD( CMonsterMaker, m_iMaxLiveChildren, FIELD_INTEGER ),
 	DEFINE_FIELD( CMonsterMaker, m_fActive, FIELD_BOOLEAN ),
 	DEFINE_FIELD( CMonsterMaker, m_fFadeChildren, FIELD_BOOLEAN ),
+	DEFINE_FIELD( CMonsterMaker, m_fGroundSet, FIELD_BOOLEAN ),
+	DEFINE_FIELD( CMonsterMaker, m_fSleeping, FIELD_BOOLEAN ),
+	DEFINE_FIELD( CMonsterMaker, m_flSleepTime, FIELD_TIME ),
 };
 
 
@@ -146,6 +156,8 @@ void CMonsterMaker :: Spawn( )
 	}
 
 	m_flGround = 0;
+	m_fGroundSet = FALSE;
+	m_fSleeping = FALSE;
 }
 
 void CMonsterMaker :: Precache( void )
@@ -168,13 +180,14 @@ void CMonsterMaker::MakeMonster( void )
 		return;
 	}
 
-	if ( !m_flGround )
+	if ( !m_fGroundSet )
 	{
 		// set altitude. Now that I'm activated, any breakables, etc should be out from under me. 
 		TraceResult tr;
 
 		UTIL_TraceLine ( pev->origin, pev->origin - Vector ( 0, 0, 2048 ), ignore_monsters, ENT(pev), &tr );
 		m_flGround = tr.vecEndPos.z;
+		m_fGroundSet = TRUE;
 	}
 
 	Vector mins = pev->origin - Vector( 34, 34, 0 );
@@ -182,13 +195,21 @@ void CMonsterMaker::MakeMonster( void )
 	maxs.z = pev->origin.z;
 	mins.z = m_flGround;
 
+	// whatever blocked us last time is usually still there, which saves searching every entity
+	if ( FBlockerInBox( mins, maxs ) )
+	{
+		return;
+	}
+
 	CBaseEntity *pList[2];
 	int count = UTIL_EntitiesInBox( pList, 2, mins, maxs, FL_CLIENT|FL_MONSTER );
 	if ( count )
 	{
 		// don't build a stack of monsters!
+		m_hBlocker = pList[0];
 		return;
 	}
+	m_hBlocker = NULL;
 
 	pent = CREATE_NAMED_ENTITY( m_iszMonsterClassname );
 
@@ -221,6 +242,7 @@ void CMonsterMaker::MakeMonster( void )
 	{
 		// if I have a netname (overloaded), give the child monster that name as a targetname
 		pevCreate->targetname = pev->netname;
+		UTIL_EntityNameChanged( ENT( pevCreate ) );
 	}
 
 	m_cLiveChildren++;// count this monster
@@ -234,6 +256,40 @@ void CMonsterMaker::MakeMonster( void )
 	}
 }
 
+//=========================================================
+// FBlockerInBox - returns TRUE if the entity that blocked
+// the last drop would still be found by the same
+// UTIL_EntitiesInBox search.
+//=========================================================
+BOOL CMonsterMaker::FBlockerInBox( const Vector &mins, const Vector &maxs )
+{
+	CBaseEntity *pBlocker = m_hBlocker;
+
+	if ( !pBlocker )
+	{
+		return FALSE;
+	}
+
+	entvars_t *pevBlocker = pBlocker->pev;
+
+	if ( !( pevBlocker->flags & ( FL_CLIENT|FL_MONSTER ) ) )
+	{
+		return FALSE;
+	}
+
+	if ( mins.x > pevBlocker->absmax.x ||
+		 mins.y > pevBlocker->absmax.y ||
+		 mins.z > pevBlocker->absmax.z ||
+		 maxs.x < pevBlocker->absmin.x ||
+		 maxs.y < pevBlocker->absmin.y ||
+		 maxs.z < pevBlocker->absmin.z )
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 //=========================================================
 // CyclicUse - drops one monster from the monstermaker
 // each time we call this.
@@ -251,6 +307,8 @@ void CMonsterMaker :: ToggleUse ( CBaseEntity *pActivator, CBaseEntity *pCaller,
 	if ( !ShouldToggle( useType, m_fActive ) )
 		return;
 
+	m_fSleeping = FALSE;
+
 	if ( m_fActive )
 	{
 		m_fActive = FALSE;
@@ -272,6 +330,15 @@ void CMonsterMaker :: MakerThink ( void )
 {
 	pev->nextthink = gpGlobals->time + m_flDelay;
 
+	if ( m_iMaxLiveChildren > 0 && m_cLiveChildren >= m_iMaxLiveChildren )
+	{
+		// nothing to do until one of the children dies, so stop thinking until then.
+		m_fSleeping = TRUE;
+		m_flSleepTime = gpGlobals->time;
+		pev->nextthink = 0;
+		return;
+	}
+
 	MakeMonster();
 }
 
@@ -283,6 +350,20 @@ void CMonsterMaker :: DeathNotice ( entvars_t *pevChild )
 	// ok, we've gotten the deathnotice from our child, now clear out its owner if we don't want it to fade.
 	m_cLiveChildren--;
 
+	if ( m_fSleeping )
+	{
+		// pick up on the same beat we would have thought on
+		m_fSleeping = FALSE;
+		if ( m_flDelay > 0 )
+		{
+			pev->nextthink = m_flSleepTime + m_flDelay * max( 1, ceil( ( gpGlobals->time - m_flSleepTime ) / m_flDelay ) );
+		}
+		else
+		{
+			pev->nextthink = gpGlobals->time;
+		}
+	}
+
 	if ( !m_fFadeChildren )
 	{
 		pevChild->owner = NULL;
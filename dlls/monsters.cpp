@@ -210,6 +210,7 @@ void CBaseMonster :: Listen ( void )
 	CSound	*pCurrentSound;
 
 	m_iAudibleList = SOUNDLIST_EMPTY; 
+	m_cAudibleSounds = 0;
 	ClearConditions(bits_COND_HEAR_SOUND | bits_COND_SMELL | bits_COND_SMELL_FOOD);
 	m_afSoundTypes = 0;
 
@@ -222,57 +223,80 @@ void CBaseMonster :: Listen ( void )
 		iMySounds &= m_pSchedule->iSoundMask;
 	}
 
-	iSound = CSoundEnt::ActiveList();
-
 	// UNDONE: Clear these here?
 	ClearConditions( bits_COND_HEAR_SOUND | bits_COND_SMELL_FOOD | bits_COND_SMELL );
 	hearingSensitivity = HearingSensitivity( );
 
-	while ( iSound != SOUNDLIST_EMPTY )
+	// the sound ent links up every sound this monster cares about that is close enough to hear.
+	m_iAudibleList = CSoundEnt::AudibleList( EarPosition(), iMySounds, hearingSensitivity );
+
+	for ( iSound = m_iAudibleList ; iSound != SOUNDLIST_EMPTY ; iSound = pCurrentSound->m_iNextAudible )
 	{
 		pCurrentSound = CSoundEnt::SoundPointerForIndex( iSound );
 
-		if ( pCurrentSound	&& 
-			 ( pCurrentSound->m_iType & iMySounds )	&& 
-			 ( pCurrentSound->m_vecOrigin - EarPosition() ).Length() <= pCurrentSound->m_iVolume * hearingSensitivity )
-
-		//if ( ( g_pSoundEnt->m_SoundPool[ iSound ].m_iType & iMySounds ) && ( g_pSoundEnt->m_SoundPool[ iSound ].m_vecOrigin - EarPosition()).Length () <= g_pSoundEnt->m_SoundPool[ iSound ].m_iVolume * hearingSensitivity ) 
+		if ( pCurrentSound->FIsSound() )
 		{
- 			// the monster cares about this sound, and it's close enough to hear.
-			//g_pSoundEnt->m_SoundPool[ iSound ].m_iNextAudible = m_iAudibleList;
-			pCurrentSound->m_iNextAudible = m_iAudibleList;
-			
-			if ( pCurrentSound->FIsSound() )
+			// this is an audible sound.
+			SetConditions( bits_COND_HEAR_SOUND );
+		}
+		else
+		{
+			// if not a sound, must be a smell - determine if it's just a scent, or if it's a food scent
+			if ( pCurrentSound->m_iType & ( bits_SOUND_MEAT | bits_SOUND_CARCASS ) )
 			{
-				// this is an audible sound.
-				SetConditions( bits_COND_HEAR_SOUND );
+				// the detected scent is a food item, so set both conditions.
+				// !!!BUGBUG - maybe a virtual function to determine whether or not the scent is food?
+				SetConditions( bits_COND_SMELL_FOOD );
+				SetConditions( bits_COND_SMELL );
 			}
 			else
 			{
-				// if not a sound, must be a smell - determine if it's just a scent, or if it's a food scent
-//				if ( g_pSoundEnt->m_SoundPool[ iSound ].m_iType & ( bits_SOUND_MEAT | bits_SOUND_CARCASS ) )
-				if ( pCurrentSound->m_iType & ( bits_SOUND_MEAT | bits_SOUND_CARCASS ) )
-				{
-					// the detected scent is a food item, so set both conditions.
-					// !!!BUGBUG - maybe a virtual function to determine whether or not the scent is food?
-					SetConditions( bits_COND_SMELL_FOOD );
-					SetConditions( bits_COND_SMELL );
-				}
-				else
-				{
-					// just a normal scent. 
-					SetConditions( bits_COND_SMELL );
-				}
+				// just a normal scent. 
+				SetConditions( bits_COND_SMELL );
 			}
+		}
+
+		m_afSoundTypes |= pCurrentSound->m_iType;
+
+		KeepAudibleSound( iSound );
+	}
+}
+
+//=========================================================
+// KeepAudibleSound - adds a heard sound to this monster's
+// own list. When the list is full, the farthest sound in
+// it makes room for a nearer one.
+//=========================================================
+void CBaseMonster :: KeepAudibleSound ( int iSound )
+{
+	int		i;
+	int		iFarthest;
+	float	flDist;
+	float	flFarthestDist;
+
+	if ( m_cAudibleSounds < MAX_AUDIBLE_SOUNDS )
+	{
+		m_rgiAudibleSounds[ m_cAudibleSounds++ ] = iSound;
+		return;
+	}
 
-//			m_afSoundTypes |= g_pSoundEnt->m_SoundPool[ iSound ].m_iType;
-			m_afSoundTypes |= pCurrentSound->m_iType;
+	iFarthest = 0;
+	flFarthestDist = 0;
+
+	for ( i = 0 ; i < m_cAudibleSounds ; i++ )
+	{
+		flDist = ( CSoundEnt::SoundPointerForIndex( m_rgiAudibleSounds[ i ] )->m_vecOrigin - EarPosition() ).Length();
 
-			m_iAudibleList = iSound;
+		if ( flDist > flFarthestDist )
+		{
+			iFarthest = i;
+			flFarthestDist = flDist;
 		}
+	}
 
-//		iSound = g_pSoundEnt->m_SoundPool[ iSound ].m_iNext;
-		iSound = pCurrentSound->m_iNext;
+	if ( ( CSoundEnt::SoundPointerForIndex( iSound )->m_vecOrigin - EarPosition() ).Length() < flFarthestDist )
+	{
+		m_rgiAudibleSounds[ iFarthest ] = iSound;
 	}
 }
 
@@ -323,6 +347,7 @@ void CBaseMonster :: Look ( int iDistance )
 	if ( !FBitSet( pev->spawnflags, SF_MONSTER_PRISONER ) )
 	{
 		CBaseEntity *pList[100];
+		unsigned char *pPVS = NULL;
 
 		Vector delta = Vector( iDistance, iDistance, iDistance );
 
@@ -338,7 +363,7 @@ void CBaseMonster :: Look ( int iDistance )
 			{
 				// the looker will want to consider this entity
 				// don't check anything else about an entity that can't be seen, or an entity that you don't care about.
-				if ( IRelationship( pSightEnt ) != R_NO && FInViewCone( pSightEnt ) && !FBitSet( pSightEnt->pev->flags, FL_NOTARGET ) && FVisible( pSightEnt ) )
+				if ( IRelationship( pSightEnt ) != R_NO && FInViewCone( pSightEnt ) && !FBitSet( pSightEnt->pev->flags, FL_NOTARGET ) && FVisibleInPVS( this, pSightEnt, &pPVS ) && FVisible( pSightEnt ) )
 				{
 					if ( pSightEnt->IsPlayer() )
 					{
@@ -421,15 +446,14 @@ int CBaseMonster :: ISoundMask ( void )
 //=========================================================
 CSound* CBaseMonster :: PBestSound ( void )
 {	
+	int i;
 	int iThisSound; 
 	int	iBestSound = -1;
 	float flBestDist = 8192;// so first nearby sound will become best so far.
 	float flDist;
 	CSound *pSound;
 
-	iThisSound = m_iAudibleList; 
-
-	if ( iThisSound == SOUNDLIST_EMPTY )
+	if ( m_cAudibleSounds == 0 )
 	{
 		ALERT ( at_aiconsole, "ERROR! monster %s has no audible sounds!\n", STRING(pev->classname) );
 #if _DEBUG
@@ -438,8 +462,9 @@ CSound* CBaseMonster :: PBestSound ( void )
 		return NULL;
 	}
 
-	while ( iThisSound != SOUNDLIST_EMPTY )
+	for ( i = 0 ; i < m_cAudibleSounds ; i++ )
 	{
+		iThisSound = m_rgiAudibleSounds[ i ];
 		pSound = CSoundEnt::SoundPointerForIndex( iThisSound );
 
 		if ( pSound && pSound->FIsSound() )
@@ -452,8 +477,6 @@ CSound* CBaseMonster :: PBestSound ( void )
 				flBestDist = flDist;
 			}
 		}
-
-		iThisSound = pSound->m_iNextAudible;
 	}
 	if ( iBestSound >= 0 )
 	{
@@ -472,15 +495,15 @@ CSound* CBaseMonster :: PBestSound ( void )
 //=========================================================
 CSound* CBaseMonster :: PBestScent ( void )
 {	
+	int i;
 	int iThisScent; 
 	int	iBestScent = -1;
 	float flBestDist = 8192;// so first nearby smell will become best so far.
 	float flDist;
 	CSound *pSound;
 
-	iThisScent = m_iAudibleList;// smells are in the sound list.
-
-	if ( iThisScent == SOUNDLIST_EMPTY )
+	// smells are in the sound list.
+	if ( m_cAudibleSounds == 0 )
 	{
 		ALERT ( at_aiconsole, "ERROR! PBestScent() has empty soundlist!\n" );
 #if _DEBUG
@@ -489,8 +512,9 @@ CSound* CBaseMonster :: PBestScent ( void )
 		return NULL;
 	}
 
-	while ( iThisScent != SOUNDLIST_EMPTY )
+	for ( i = 0 ; i < m_cAudibleSounds ; i++ )
 	{
+		iThisScent = m_rgiAudibleSounds[ i ];
 		pSound = CSoundEnt::SoundPointerForIndex( iThisScent );
 
 		if ( pSound->FIsScent() )
@@ -503,8 +527,6 @@ CSound* CBaseMonster :: PBestScent ( void )
 				flBestDist = flDist;
 			}
 		}
-
-		iThisScent = pSound->m_iNextAudible;
 	}
 	if ( iBestScent >= 0 )
 	{
@@ -83,6 +83,8 @@ extern void ExplodeModel( const Vector &vecOrigin, float speed, int model, int c
 
 BOOL FBoxVisible ( entvars_t *pevLooker, entvars_t *pevTarget );
 BOOL FBoxVisible ( entvars_t *pevLooker, entvars_t *pevTarget, Vector &vecTargetOrigin, float flSize = 0.0 );
+BOOL FVisibleInPVS( CBaseEntity *pLooker, CBaseEntity *pTarget, unsigned char **ppPVS );
+void VisibilityCacheStats( int *pTraces, int *pSaved );
 
 // monster to monster relationship types
 #define R_AL	-2 // (ALLY) pals. Good alternative to R_NO when applicable.
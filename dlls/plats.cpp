@@ -2462,6 +2462,7 @@ void CGunTarget::Die()
 
 	// Don't fire something that could fire myself
 	pev->targetname = 0;
+	UTIL_EntityNameChanged( edict() );
 
 	pev->solid = SOLID_NOT;
 	// Fire targets on break
@@ -1021,8 +1021,7 @@ int CBasePlayer :: TakeDamage( entvars_t *pevInflictor, entvars_t *pevAttacker,
 					) {
 						sprintf_s( fileName, "max/pain/SELF_PAIN_%d.wav", RANDOM_LONG( 1, 20 ) );
 
-						// sorry for this memory leak
-						AddToSoundQueue( ALLOC_STRING( fileName ), 1.5f, true );
+						AddToSoundQueue( UTIL_AllocPooledString( fileName ), 1.5f, true );
 					}
 				}
 			}
@@ -2483,7 +2482,7 @@ void CBasePlayer::PlayMusicDelayed( const std::string &filePath, float delay, fl
 	if ( delay <= 0.0f ) {
 		SendPlayMusicMessage( filePath, musicPos, looping, noSlowmotionEffects );
 	} else {
-		delayedMusicFilePath = ALLOC_STRING( filePath.c_str() ); // memory leak
+		delayedMusicFilePath = UTIL_AllocPooledString( filePath.c_str() );
 		delayedMusicStartTime = gpGlobals->time + delay;
 		delayedMusicStartPos = musicPos;
 		delayedMusicLooping = looping;
@@ -3697,6 +3696,33 @@ pt_end:
 }
 
 
+// checks the other player edicts against the radius, measured to the nearest point
+// of their bounding box and origin so it is never further than the engine's sphere
+// search measures, with an inch to spare
+static BOOL AnyPlayerNearSpot( CBaseEntity *pPlayer, const Vector &vecSpot, float flRadius )
+{
+	for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+	{
+		edict_t *pEdict = INDEXENT( i );
+
+		if ( !pEdict || pEdict->free || pEdict == pPlayer->edict() )
+			continue;
+
+		Vector vecNearest;
+		for ( int j = 0; j < 3; j++ )
+		{
+			float flMin = pEdict->v.origin[j] + min( pEdict->v.mins[j], 0 );
+			float flMax = pEdict->v.origin[j] + max( pEdict->v.maxs[j], 0 );
+			vecNearest[j] = max( flMin, min( vecSpot[j], flMax ) );
+		}
+
+		if ( ( vecNearest - vecSpot ).Length() <= flRadius + 1 )
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
 // checks if the spot is clear of players
 BOOL IsSpawnPointValid( CBaseEntity *pPlayer, CBaseEntity *pSpot )
 {
@@ -3707,6 +3733,13 @@ BOOL IsSpawnPointValid( CBaseEntity *pPlayer, CBaseEntity *pSpot )
 		return FALSE;
 	}
 
+	// The sphere search goes through every entity, only players matter and
+	// they are the first edicts, so skip it when none of them are near
+	if ( !AnyPlayerNearSpot( pPlayer, pSpot->pev->origin, 128 ) )
+	{
+		return TRUE;
+	}
+
 	while ( (ent = UTIL_FindEntityInSphere( ent, pSpot->pev->origin, 128 )) != NULL )
 	{
 		// if ent is a client, don't spawn on 'em
@@ -5564,6 +5597,11 @@ void CBasePlayer :: UpdateClientData( void )
 			WRITE_BYTE( 0 );
 		MESSAGE_END();
 
+		// Client HUD elements are cleared, game mode HUD has to be sent again
+		if ( CCustomGameModeRules *cgm = dynamic_cast< CCustomGameModeRules * >( g_pGameRules ) ) {
+			cgm->ForceHUDMessages();
+		}
+
 		if ( !m_fGameHUDInitialized )
 		{
 			MESSAGE_BEGIN( MSG_ONE, gmsgInitHUD, NULL, pev );
@@ -0,0 +1,363 @@
+/***
+*
+*	Copyright (c) 1996-2001, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+/*
+
+===== precache.cpp ========================================================
+
+  Registry of everything the server precaches on the current map.
+
+  Precaching is spread over ClientPrecache, W_Precache, every entity's
+  Precache and the custom game mode configs, and the same resource is
+  asked for many times over. The registry hands out the engine's index
+  again for a repeat without calling the engine, counts resources against
+  the engine limits and keeps a manifest of what the map needed.
+
+  precache_manifest 1 precaches the recorded manifest of a map in one pass
+  before entities spawn, and writes it again when the map needed something
+  else. precache_manifest 2 does the same and then loads the next map in
+  maps/*.bsp, to build manifests for all maps at once.
+
+*/
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "game.h"
+#include "precache.h"
+#include "fs_aux.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef _LINUX
+#include <sys/stat.h>
+#define CreateDirectory(p, n) mkdir(p, 0777)
+#endif
+
+// Lump holding brush models in a BSP file, each dmodel_t is 64 bytes
+#define BSP_LUMP_MODELS		14
+#define BSP_MODEL_SIZE		64
+
+enum
+{
+	PRECACHE_MODEL_TABLE = 0,
+	PRECACHE_SOUND_TABLE,
+	PRECACHE_GENERIC_TABLE,
+
+	PRECACHE_TABLES
+};
+
+static const char *g_rgszPrecacheTableNames[PRECACHE_TABLES] = { "model", "sound", "generic" };
+static const int g_rgiPrecacheTableLimits[PRECACHE_TABLES] = { MAX_PRECACHE_MODELS, MAX_PRECACHE_SOUNDS, MAX_PRECACHE_GENERIC };
+
+typedef struct
+{
+	std::string		name;
+	int				index;		// what the engine returned
+	BOOL			fNeeded;	// asked for by the game, not only by the manifest
+} precacheentry_t;
+
+typedef struct
+{
+	std::unordered_map<std::string, int>	lookup;		// name -> entries slot
+	std::vector<precacheentry_t>			entries;	// in precache order
+	int										repeats;	// calls answered without the engine
+	int										manifested;	// entries read from the manifest
+} precachetable_t;
+
+static precachetable_t g_PrecacheTables[PRECACHE_TABLES];
+static std::unordered_set<std::string> g_PrecachedClasses;
+static int g_iPrecacheOtherRepeats = 0;
+
+// Manifest of the current map, and whether it was read from disk
+static std::string g_szManifestName;
+static BOOL g_fManifestLoaded = FALSE;
+
+static int PrecacheResource( int table, const char *s, BOOL fNeeded )
+{
+	precachetable_t &precache = g_PrecacheTables[table];
+
+	auto it = precache.lookup.find( s );
+	if ( it != precache.lookup.end() )
+	{
+		precacheentry_t &entry = precache.entries[it->second];
+
+		if ( fNeeded )
+		{
+			// Loaded from the manifest earlier, first real request isn't a repeat
+			if ( entry.fNeeded )
+				precache.repeats++;
+			entry.fNeeded = TRUE;
+		}
+
+		return entry.index;
+	}
+
+	// Engine keeps the pointer, callers pass string literals or engine strings
+	int index;
+	switch ( table )
+	{
+	case PRECACHE_MODEL_TABLE:
+		index = (*g_engfuncs.pfnPrecacheModel)( (char *)s );
+		break;
+	case PRECACHE_SOUND_TABLE:
+		index = (*g_engfuncs.pfnPrecacheSound)( (char *)s );
+		break;
+	default:
+		index = (*g_engfuncs.pfnPrecacheGeneric)( (char *)s );
+		break;
+	}
+
+	precacheentry_t entry;
+	entry.name = s;
+	entry.index = index;
+	entry.fNeeded = fNeeded;
+
+	precache.lookup[entry.name] = (int)precache.entries.size();
+	precache.entries.push_back( entry );
+
+	return index;
+}
+
+int UTIL_PrecacheModel( const char *s )
+{
+	return PrecacheResource( PRECACHE_MODEL_TABLE, s, TRUE );
+}
+
+int UTIL_PrecacheSound( const char *s )
+{
+	return PrecacheResource( PRECACHE_SOUND_TABLE, s, TRUE );
+}
+
+int UTIL_PrecacheGeneric( const char *s )
+{
+	return PrecacheResource( PRECACHE_GENERIC_TABLE, s, TRUE );
+}
+
+void UTIL_ResetPrecache( void )
+{
+	for ( int i = 0; i < PRECACHE_TABLES; i++ )
+	{
+		g_PrecacheTables[i].lookup.clear();
+		g_PrecacheTables[i].entries.clear();
+		g_PrecacheTables[i].repeats = 0;
+		g_PrecacheTables[i].manifested = 0;
+	}
+
+	g_PrecachedClasses.clear();
+	g_iPrecacheOtherRepeats = 0;
+
+	g_szManifestName = STRING( gpGlobals->mapname );
+	g_fManifestLoaded = FALSE;
+}
+
+//=========================================================
+// UTIL_FirstPrecacheOther - UTIL_PrecacheOther creates and
+// removes an entity just to run its Precache, which only
+// has to happen once per map for each class.
+//=========================================================
+BOOL UTIL_FirstPrecacheOther( const char *szClassname )
+{
+	if ( g_PrecachedClasses.insert( szClassname ).second )
+		return TRUE;
+
+	g_iPrecacheOtherRepeats++;
+	return FALSE;
+}
+
+static std::string PrecacheManifestPath( BOOL fCreateDirectory )
+{
+	char szPath[MAX_PATH];
+
+	GET_GAME_DIR( szPath );
+	strcat( szPath, "/maps" );
+	if ( fCreateDirectory )
+		CreateDirectory( szPath, NULL );
+	strcat( szPath, "/precache" );
+	if ( fCreateDirectory )
+		CreateDirectory( szPath, NULL );
+
+	return std::string( szPath ) + "/" + g_szManifestName + ".txt";
+}
+
+//=========================================================
+// UTIL_LoadPrecacheManifest - precaches what the map and
+// configs needed last time, in the same order, so entity
+// precaches afterwards are answered by the registry.
+//
+// Manifest lines are "<model|sound|generic> <path>".
+//=========================================================
+void UTIL_LoadPrecacheManifest( const char *pszManifestName )
+{
+	g_szManifestName = pszManifestName;
+
+	if ( !precache_manifest.value || g_fManifestLoaded )
+		return;
+
+	std::string path = PrecacheManifestPath( FALSE );
+	FILE *file = fopen( path.c_str(), "r" );
+	if ( !file )
+		return;
+
+	g_fManifestLoaded = TRUE;
+
+	char szLine[512];
+	while ( fgets( szLine, sizeof( szLine ), file ) )
+	{
+		char *pszName = strchr( szLine, ' ' );
+		if ( !pszName )
+			continue;
+
+		*pszName++ = 0;
+		pszName[strcspn( pszName, "\r\n" )] = 0;
+		if ( !*pszName )
+			continue;
+
+		for ( int table = 0; table < PRECACHE_TABLES; table++ )
+		{
+			if ( !strcmp( szLine, g_rgszPrecacheTableNames[table] ) )
+			{
+				// Engine keeps the pointer
+				PrecacheResource( table, STRING( UTIL_AllocPooledString( pszName ) ), FALSE );
+				break;
+			}
+		}
+	}
+
+	fclose( file );
+
+	for ( int table = 0; table < PRECACHE_TABLES; table++ )
+		g_PrecacheTables[table].manifested = (int)g_PrecacheTables[table].entries.size();
+}
+
+static int PrecacheTableCount( int table, BOOL fNeededOnly )
+{
+	int count = 0;
+	const std::vector<precacheentry_t> &entries = g_PrecacheTables[table].entries;
+
+	for ( size_t i = 0; i < entries.size(); i++ )
+	{
+		// Brush models are counted from the BSP
+		if ( table == PRECACHE_MODEL_TABLE && entries[i].name[0] == '*' )
+			continue;
+
+		if ( !fNeededOnly || entries[i].fNeeded )
+			count++;
+	}
+
+	return count;
+}
+
+// World and its brush models take model slots without anyone precaching them
+static int BrushModelCount( void )
+{
+	int length = 0;
+	byte *pFile = LOAD_FILE_FOR_ME( UTIL_VarArgs( "maps/%s.bsp", STRING( gpGlobals->mapname ) ), &length );
+	if ( !pFile )
+		return 0;
+
+	int count = 0;
+	int lumpOffset = 4 + BSP_LUMP_MODELS * 8;
+	if ( length >= lumpOffset + 8 )
+		count = *(int *)( pFile + lumpOffset + 4 ) / BSP_MODEL_SIZE;
+
+	FREE_FILE( pFile );
+	return count;
+}
+
+static BOOL WritePrecacheManifest( void )
+{
+	std::string path = PrecacheManifestPath( TRUE );
+	FILE *file = fopen( path.c_str(), "w" );
+	if ( !file )
+	{
+		ALERT( at_console, "Couldn't write precache manifest %s\n", path.c_str() );
+		return FALSE;
+	}
+
+	for ( int table = 0; table < PRECACHE_TABLES; table++ )
+	{
+		const std::vector<precacheentry_t> &entries = g_PrecacheTables[table].entries;
+
+		for ( size_t i = 0; i < entries.size(); i++ )
+		{
+			if ( entries[i].fNeeded )
+				fprintf( file, "%s %s\n", g_rgszPrecacheTableNames[table], entries[i].name.c_str() );
+		}
+	}
+
+	fclose( file );
+	return TRUE;
+}
+
+static void NextManifestMap( void )
+{
+	std::set<std::string> maps = FS_GetAllFileNamesByWildcard( "maps/*.bsp" );
+	std::string current = std::string( STRING( gpGlobals->mapname ) ) + ".bsp";
+
+	auto it = maps.upper_bound( current );
+	if ( it == maps.end() )
+	{
+		ALERT( at_console, "Precache manifests built for %d maps\n", (int)maps.size() );
+		CVAR_SET_FLOAT( "precache_manifest", 1 );
+		return;
+	}
+
+	std::string next = it->substr( 0, it->size() - 4 );
+	SERVER_COMMAND( (char *)UTIL_VarArgs( "map %s\n", next.c_str() ) );
+}
+
+//=========================================================
+// UTIL_FinishPrecache - reports precache use against the
+// engine limits and keeps the manifest up to date.
+//=========================================================
+void UTIL_FinishPrecache( void )
+{
+	if ( !precache_manifest.value )
+		return;
+
+	int brushModels = BrushModelCount();
+	BOOL fChanged = !g_fManifestLoaded;
+
+	ALERT( at_console, "Precache %s:\n", g_szManifestName.c_str() );
+	for ( int table = 0; table < PRECACHE_TABLES; table++ )
+	{
+		int used = PrecacheTableCount( table, FALSE );
+		int needed = PrecacheTableCount( table, TRUE );
+		if ( table == PRECACHE_MODEL_TABLE )
+		{
+			used += brushModels;
+			needed += brushModels;
+		}
+
+		// Manifest is rewritten when the map needed less or more than it recorded
+		if ( used != needed || (int)g_PrecacheTables[table].entries.size() != g_PrecacheTables[table].manifested )
+			fChanged = TRUE;
+
+		ALERT( at_console, "  %-8s %3d / %d%s, %d unused from manifest, %d repeats skipped\n",
+			g_rgszPrecacheTableNames[table], used, g_rgiPrecacheTableLimits[table],
+			used >= g_rgiPrecacheTableLimits[table] * 9 / 10 ? " (near limit)" : "",
+			used - needed, g_PrecacheTables[table].repeats );
+	}
+	ALERT( at_console, "  %d classes precached, %d repeats skipped\n", (int)g_PrecachedClasses.size(), g_iPrecacheOtherRepeats );
+
+	if ( fChanged && WritePrecacheManifest() )
+		ALERT( at_console, "Wrote precache manifest %s\n", g_szManifestName.c_str() );
+
+	if ( precache_manifest.value == 2 )
+		NextManifestMap();
+}
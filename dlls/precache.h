@@ -0,0 +1,38 @@
+/***
+*
+*	Copyright (c) 1996-2001, Valve LLC. All rights reserved.
+*	
+*	This product contains software technology licensed from Id 
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc. 
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#ifndef PRECACHE_H
+#define PRECACHE_H
+
+// Engine limits of the precache tables
+#define MAX_PRECACHE_MODELS		512
+#define MAX_PRECACHE_SOUNDS		512
+#define MAX_PRECACHE_GENERIC	512
+
+// PRECACHE_MODEL, PRECACHE_SOUND and PRECACHE_GENERIC are declared in enginecallback.h
+
+// Forget everything precached by the previous map, called first thing in CWorld::Precache
+extern void UTIL_ResetPrecache( void );
+
+// FALSE if this classname was already precached through UTIL_PrecacheOther on this map
+extern BOOL UTIL_FirstPrecacheOther( const char *szClassname );
+
+// Precache everything the manifest of this map and config combination recorded last time
+extern void UTIL_LoadPrecacheManifest( const char *pszManifestName );
+
+// Called from ServerActivate when precaching is over
+extern void UTIL_FinishPrecache( void );
+
+#endif // PRECACHE_H
@@ -0,0 +1,335 @@
+/***
+*
+*	Copyright (c) 1996-2001, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+/*
+
+===== server_profile.cpp ========================================================
+
+  Frame timing of the game DLL inside the running engine.
+
+  "sv_profile 300" times the next 300 server frames. For repeatable numbers
+  run the same map and spawns each time with a fixed host_framerate, e.g.
+  "map c1a0; host_framerate 0.01; sv_profile 1000", or play back an input
+  recording with replay_play on the client.
+
+  While profiling, the message functions in g_engfuncs are swapped for ones
+  which count what the game DLL sends before passing it on to the engine.
+
+*/
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "game.h"
+#include "server_profile.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#ifdef _LINUX
+#include <sys/stat.h>
+#define CreateDirectory(p, n) mkdir(p, 0777)
+#endif
+
+static const char *g_rgszProfileSections[PROFILE_SECTIONS] = { "startframe", "prethink", "postthink", "think", "touch", "fullpack" };
+
+typedef struct
+{
+	float	time;
+	int		entities;
+	double	frame;		// whole server frame, engine included
+	double	sections[PROFILE_SECTIONS];
+	int		messages;
+	int		messageBytes;
+} profileframe_t;
+
+static std::vector<profileframe_t> g_ProfileFrames;
+
+// Think time by classname, classname strings are engine strings and don't move
+static std::unordered_map<const char *, double> g_ProfileThinkClasses;
+
+CServerProfiler g_ServerProfiler;
+
+//=========================================================
+// Message counting
+//=========================================================
+static enginefuncs_t g_ProfileEngineFuncs;
+static int g_iProfileMessages = 0;
+static int g_iProfileMessageBytes = 0;
+
+static void ProfileMessageBegin( int msg_dest, int msg_type, const float *pOrigin, edict_t *ed )
+{
+	g_iProfileMessages++;
+	g_iProfileMessageBytes++;	// message type
+	(*g_ProfileEngineFuncs.pfnMessageBegin)( msg_dest, msg_type, pOrigin, ed );
+}
+
+static void ProfileWriteByte( int iValue )
+{
+	g_iProfileMessageBytes++;
+	(*g_ProfileEngineFuncs.pfnWriteByte)( iValue );
+}
+
+static void ProfileWriteChar( int iValue )
+{
+	g_iProfileMessageBytes++;
+	(*g_ProfileEngineFuncs.pfnWriteChar)( iValue );
+}
+
+static void ProfileWriteShort( int iValue )
+{
+	g_iProfileMessageBytes += 2;
+	(*g_ProfileEngineFuncs.pfnWriteShort)( iValue );
+}
+
+static void ProfileWriteLong( int iValue )
+{
+	g_iProfileMessageBytes += 4;
+	(*g_ProfileEngineFuncs.pfnWriteLong)( iValue );
+}
+
+static void ProfileWriteAngle( float flValue )
+{
+	g_iProfileMessageBytes++;
+	(*g_ProfileEngineFuncs.pfnWriteAngle)( flValue );
+}
+
+static void ProfileWriteCoord( float flValue )
+{
+	g_iProfileMessageBytes += 2;
+	(*g_ProfileEngineFuncs.pfnWriteCoord)( flValue );
+}
+
+static void ProfileWriteString( const char *sz )
+{
+	g_iProfileMessageBytes += strlen( sz ) + 1;
+	(*g_ProfileEngineFuncs.pfnWriteString)( sz );
+}
+
+static void ProfileWriteEntity( int iValue )
+{
+	g_iProfileMessageBytes += 2;
+	(*g_ProfileEngineFuncs.pfnWriteEntity)( iValue );
+}
+
+static void HookMessageFuncs( void )
+{
+	g_ProfileEngineFuncs = g_engfuncs;
+
+	g_engfuncs.pfnMessageBegin	= ProfileMessageBegin;
+	g_engfuncs.pfnWriteByte		= ProfileWriteByte;
+	g_engfuncs.pfnWriteChar		= ProfileWriteChar;
+	g_engfuncs.pfnWriteShort	= ProfileWriteShort;
+	g_engfuncs.pfnWriteLong		= ProfileWriteLong;
+	g_engfuncs.pfnWriteAngle	= ProfileWriteAngle;
+	g_engfuncs.pfnWriteCoord	= ProfileWriteCoord;
+	g_engfuncs.pfnWriteString	= ProfileWriteString;
+	g_engfuncs.pfnWriteEntity	= ProfileWriteEntity;
+}
+
+static void UnhookMessageFuncs( void )
+{
+	g_engfuncs.pfnMessageBegin	= g_ProfileEngineFuncs.pfnMessageBegin;
+	g_engfuncs.pfnWriteByte		= g_ProfileEngineFuncs.pfnWriteByte;
+	g_engfuncs.pfnWriteChar		= g_ProfileEngineFuncs.pfnWriteChar;
+	g_engfuncs.pfnWriteShort	= g_ProfileEngineFuncs.pfnWriteShort;
+	g_engfuncs.pfnWriteLong		= g_ProfileEngineFuncs.pfnWriteLong;
+	g_engfuncs.pfnWriteAngle	= g_ProfileEngineFuncs.pfnWriteAngle;
+	g_engfuncs.pfnWriteCoord	= g_ProfileEngineFuncs.pfnWriteCoord;
+	g_engfuncs.pfnWriteString	= g_ProfileEngineFuncs.pfnWriteString;
+	g_engfuncs.pfnWriteEntity	= g_ProfileEngineFuncs.pfnWriteEntity;
+}
+
+CServerProfiler::CServerProfiler( void )
+{
+	m_fActive = FALSE;
+	m_iFramesLeft = 0;
+	m_iDepth = 0;
+	memset( m_flSections, 0, sizeof( m_flSections ) );
+}
+
+void CServerProfiler::StartFrame( void )
+{
+	if ( m_fActive )
+	{
+		EndFrame();
+
+		if ( --m_iFramesLeft <= 0 )
+			Finish();
+	}
+	else if ( sv_profile.value >= 1 )
+	{
+		Begin( (int)sv_profile.value );
+	}
+
+	if ( m_fActive )
+	{
+		m_FrameStart = clock::now();
+		memset( m_flSections, 0, sizeof( m_flSections ) );
+		g_iProfileMessages = 0;
+		g_iProfileMessageBytes = 0;
+	}
+}
+
+void CServerProfiler::Begin( int frames )
+{
+	ALERT( at_console, "Profiling %d server frames\n", frames );
+
+	g_ProfileFrames.clear();
+	g_ProfileFrames.reserve( frames );
+	g_ProfileThinkClasses.clear();
+
+	m_fActive = TRUE;
+	m_iFramesLeft = frames;
+	m_iDepth = 0;
+
+	HookMessageFuncs();
+}
+
+void CServerProfiler::Enter( void )
+{
+	if ( m_iDepth++ == 0 )
+		m_SectionStart = clock::now();
+}
+
+void CServerProfiler::Leave( int section, edict_t *pent )
+{
+	// Profiling started inside this scope
+	if ( m_iDepth <= 0 )
+		return;
+
+	if ( --m_iDepth > 0 )
+		return;
+
+	double msec = std::chrono::duration<double, std::milli>( clock::now() - m_SectionStart ).count();
+	m_flSections[section] += msec;
+
+	if ( section == PROFILE_THINK && pent )
+		g_ProfileThinkClasses[STRING( pent->v.classname )] += msec;
+}
+
+void CServerProfiler::EndFrame( void )
+{
+	profileframe_t frame;
+
+	frame.time = gpGlobals->time;
+	frame.entities = NUMBER_OF_ENTITIES();
+	frame.frame = std::chrono::duration<double, std::milli>( clock::now() - m_FrameStart ).count();
+	memcpy( frame.sections, m_flSections, sizeof( frame.sections ) );
+	frame.messages = g_iProfileMessages;
+	frame.messageBytes = g_iProfileMessageBytes;
+
+	g_ProfileFrames.push_back( frame );
+}
+
+static void ProfileReportLine( const char *pszName, std::vector<double> &samples )
+{
+	if ( samples.empty() )
+		return;
+
+	double total = 0;
+	for ( size_t i = 0; i < samples.size(); i++ )
+		total += samples[i];
+
+	std::sort( samples.begin(), samples.end() );
+
+	ALERT( at_console, "  %-12s avg %7.3f  p95 %7.3f  max %7.3f ms\n", pszName,
+		total / samples.size(), samples[samples.size() * 95 / 100], samples.back() );
+}
+
+static void WriteProfileCSV( void )
+{
+	char szPath[MAX_PATH];
+
+	GET_GAME_DIR( szPath );
+	strcat( szPath, "/profile" );
+	CreateDirectory( szPath, NULL );
+	strcat( szPath, "/" );
+	strcat( szPath, sv_profile_name.string[0] ? sv_profile_name.string : STRING( gpGlobals->mapname ) );
+	strcat( szPath, ".csv" );
+
+	FILE *file = fopen( szPath, "w" );
+	if ( !file )
+	{
+		ALERT( at_console, "Couldn't write %s\n", szPath );
+		return;
+	}
+
+	fprintf( file, "frame,time,entities,messages,message_bytes,frame_ms" );
+	for ( int i = 0; i < PROFILE_SECTIONS; i++ )
+		fprintf( file, ",%s_ms", g_rgszProfileSections[i] );
+	fprintf( file, "\n" );
+
+	for ( size_t i = 0; i < g_ProfileFrames.size(); i++ )
+	{
+		const profileframe_t &frame = g_ProfileFrames[i];
+
+		fprintf( file, "%d,%.4f,%d,%d,%d,%.4f", (int)i, frame.time, frame.entities, frame.messages, frame.messageBytes, frame.frame );
+		for ( int j = 0; j < PROFILE_SECTIONS; j++ )
+			fprintf( file, ",%.4f", frame.sections[j] );
+		fprintf( file, "\n" );
+	}
+
+	fclose( file );
+	ALERT( at_console, "Wrote %s\n", szPath );
+}
+
+void CServerProfiler::Finish( void )
+{
+	m_fActive = FALSE;
+	CVAR_SET_FLOAT( "sv_profile", 0 );
+
+	UnhookMessageFuncs();
+
+	if ( g_ProfileFrames.empty() )
+		return;
+
+	int maxEntities = 0;
+	int messageBytes = 0;
+	std::vector<double> samples;
+	samples.reserve( g_ProfileFrames.size() );
+
+	ALERT( at_console, "Server profile of %s, %d frames:\n", STRING( gpGlobals->mapname ), (int)g_ProfileFrames.size() );
+
+	for ( size_t i = 0; i < g_ProfileFrames.size(); i++ )
+	{
+		samples.push_back( g_ProfileFrames[i].frame );
+		maxEntities = max( maxEntities, g_ProfileFrames[i].entities );
+		messageBytes += g_ProfileFrames[i].messageBytes;
+	}
+	ProfileReportLine( "frame", samples );
+
+	for ( int section = 0; section < PROFILE_SECTIONS; section++ )
+	{
+		samples.clear();
+		for ( size_t i = 0; i < g_ProfileFrames.size(); i++ )
+			samples.push_back( g_ProfileFrames[i].sections[section] );
+		ProfileReportLine( g_rgszProfileSections[section], samples );
+	}
+
+	// Classes which think the most, per frame
+	std::vector<std::pair<double, const char *>> classes;
+	for ( const auto &thinkClass : g_ProfileThinkClasses )
+		classes.push_back( std::make_pair( thinkClass.second, thinkClass.first ) );
+	std::sort( classes.rbegin(), classes.rend() );
+
+	for ( size_t i = 0; i < classes.size() && i < 10; i++ )
+		ALERT( at_console, "  think %-24s %7.3f ms\n", classes[i].second, classes[i].first / g_ProfileFrames.size() );
+
+	ALERT( at_console, "  up to %d entities, %d message bytes per frame\n", maxEntities, messageBytes / (int)g_ProfileFrames.size() );
+
+	WriteProfileCSV();
+}
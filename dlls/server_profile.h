@@ -0,0 +1,96 @@
+/***
+*
+*	Copyright (c) 1996-2001, Valve LLC. All rights reserved.
+*
+*	This product contains software technology licensed from Id
+*	Software, Inc. ("Id Technology").  Id Technology (c) 1996 Id Software, Inc.
+*	All Rights Reserved.
+*
+*   Use, distribution, and modification of this source code and/or resulting
+*   object code is restricted to non-commercial enhancements to products from
+*   Valve LLC.  All other use, distribution, or modification is prohibited
+*   without written permission from Valve LLC.
+*
+****/
+
+#ifndef SERVER_PROFILE_H
+#define SERVER_PROFILE_H
+
+#include <chrono>
+
+// Parts of a server frame spent in the game DLL
+enum
+{
+	PROFILE_STARTFRAME = 0,
+	PROFILE_PRETHINK,
+	PROFILE_POSTTHINK,
+	PROFILE_THINK,
+	PROFILE_TOUCH,
+	PROFILE_ADDTOFULLPACK,
+
+	PROFILE_SECTIONS
+};
+
+//=========================================================
+// CServerProfiler - times the game DLL entry points over
+// sv_profile frames, then prints a report and writes one
+// CSV row per frame to <gamedir>/profile/<map>.csv.
+//=========================================================
+class CServerProfiler
+{
+public:
+	CServerProfiler( void );
+
+	// Called first thing in StartFrame, closes the previous frame
+	void StartFrame( void );
+
+	BOOL IsActive( void ) const { return m_fActive; }
+
+	void Enter( void );
+	void Leave( int section, edict_t *pent );
+
+private:
+	void Begin( int frames );
+	void EndFrame( void );
+	void Finish( void );
+
+	typedef std::chrono::steady_clock clock;
+
+	BOOL	m_fActive;
+	int		m_iFramesLeft;
+	int		m_iDepth;
+
+	clock::time_point	m_FrameStart;
+	clock::time_point	m_SectionStart;
+	double				m_flSections[PROFILE_SECTIONS];
+};
+
+extern CServerProfiler g_ServerProfiler;
+
+//=========================================================
+// CServerProfileScope - times the rest of the block as one
+// section, nested scopes are counted by the outermost one.
+//=========================================================
+class CServerProfileScope
+{
+public:
+	CServerProfileScope( int section, edict_t *pent = NULL )
+	{
+		m_iSection = section;
+		m_pent = pent;
+		if ( g_ServerProfiler.IsActive() )
+			g_ServerProfiler.Enter();
+	}
+
+	~CServerProfileScope()
+	{
+		if ( g_ServerProfiler.IsActive() )
+			g_ServerProfiler.Leave( m_iSection, m_pent );
+	}
+
+private:
+	int		m_iSection;
+	edict_t	*m_pent;
+};
+
+#endif // SERVER_PROFILE_H
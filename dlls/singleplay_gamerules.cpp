@@ -163,7 +163,7 @@ void CHalfLifeRules::HookModelIndex( CBaseEntity *activator, int modelIndex, con
 	std::string key = std::string( STRING( gpGlobals->mapname ) ) + "_" + std::to_string( modelIndex ) + "_" + className + "_" + targetName;
 	bool firstTime = !pPlayer->ModelIndexHasBeenHooked( key.c_str() );
 	if ( firstTime ) {
-		pPlayer->RememberHookedModelIndex( ALLOC_STRING( key.c_str() ) ); // sorry for memory leak
+		pPlayer->RememberHookedModelIndex( UTIL_AllocPooledString( key.c_str() ) );
 
 		if ( targetName == "kerotan_found" ) {
 			pPlayer->RememberKerotanOnCurrentMap();
@@ -188,14 +188,14 @@ void CHalfLifeRules::OnHookedModelIndex( CBasePlayer *pPlayer, CBaseEntity *acti
 
 		for ( const auto &sound : config->sounds ) {
 			if ( sound.Fits( modelIndex, className, targetName, firstTime ) ) {
-				pPlayer->AddToSoundQueue( ALLOC_STRING( sound.path.c_str() ), sound.delay, false, true );
+				pPlayer->AddToSoundQueue( UTIL_AllocPooledString( sound.path.c_str() ), sound.delay, false, true );
 			}
 		}
 
 		for ( const auto &commentary : config->maxCommentary ) {
 			if ( commentary.Fits( modelIndex, className, targetName, firstTime ) ) {
 				if ( !( gEvilImpulse101 && className.find( "weapon_" ) == 0 ) ) {
-					pPlayer->AddToSoundQueue( ALLOC_STRING( commentary.path.c_str() ), commentary.delay, true, true );
+					pPlayer->AddToSoundQueue( UTIL_AllocPooledString( commentary.path.c_str() ), commentary.delay, true, true );
 				}
 			}
 		}
@@ -290,6 +290,7 @@ void CHalfLifeRules::OnHookedModelIndex( CBasePlayer *pPlayer, CBaseEntity *acti
 					CBaseEntity *newEntity = CBaseEntity::Create( ( char * ) entityReplace.newEntity.name.c_str(), pos, ang, NULL, entityReplace.newEntity.weaponFlags, entityReplace.newEntity.spawnFlags );
 					newEntity->pev->target = target;
 					newEntity->pev->targetname = targetname;
+					UTIL_EntityNameChanged( newEntity->edict() );
 				}
 			}
 		}
@@ -314,9 +315,9 @@ void CHalfLifeRules::Precache()
 		auto soundsToPrecache = config->GetSoundsToPrecacheForMap( mapname );
 		auto entitiesToPrecache = config->GetEntitiesToPrecacheForMap( mapname );
 
-		// I'm very sorry for this memory leak for now
+		// Engine keeps the pointer, pooled strings don't leak on every map load
 		for ( const auto &sound : soundsToPrecache ) {
-			PRECACHE_SOUND( ( char * ) STRING( ALLOC_STRING( sound.c_str() ) ) );
+			PRECACHE_SOUND( STRING( UTIL_AllocPooledString( sound.c_str() ) ) );
 		}
 
 		for ( const auto &spawn : entitiesToPrecache ) {
@@ -325,6 +326,18 @@ void CHalfLifeRules::Precache()
 	}
 }
 
+// Configs change what a map precaches, so each combination has its own manifest
+std::string CHalfLifeRules::GetPrecacheManifestName() {
+	std::string name = STRING( gpGlobals->mapname );
+	for ( const auto &config : configs ) {
+		if ( !config->sha1.empty() ) {
+			name += "_" + config->sha1.substr( 0, 8 );
+		}
+	}
+
+	return name;
+}
+
 CBaseEntity* CHalfLifeRules::SpawnBySpawnData( const EntitySpawnData &spawnData, bool forceSpawn ) {
 	CBaseEntity *entity = CBaseEntity::Create(
 		allowedEntities[CustomGameModeConfig::GetAllowedEntityIndex( spawnData.name.c_str() )],
@@ -337,7 +350,8 @@ CBaseEntity* CHalfLifeRules::SpawnBySpawnData( const EntitySpawnData &spawnData,
 
 	entity->pev->spawnflags |= SF_MONSTER_PRESERVE;
 	if ( spawnData.targetName.size() > 0 ) {
-		entity->pev->targetname = ALLOC_STRING( spawnData.targetName.c_str() ); // memory leak
+		entity->pev->targetname = UTIL_AllocPooledString( spawnData.targetName.c_str() );
+		UTIL_EntityNameChanged( entity->edict() );
 	}
 
 	int dropResult = forceSpawn ? -1 : DROP_TO_FLOOR( ENT( entity->pev ) );
@@ -1020,6 +1020,63 @@ int fSentencesInit = FALSE;
 char gszallsentencenames[CVOXFILESENTENCEMAX][CBSENTENCENAME_MAX];
 int gcallsentences = 0;
 
+#define SENTENCE_HASH_SIZE		4096		// power of two, at least twice CVOXFILESENTENCEMAX
+#define SENTENCEG_HASH_SIZE		512			// power of two, at least twice CSENTENCEG_MAX
+
+// Open addressing, slot holds index + 1 into gszallsentencenames
+// or rgsentenceg, 0 if empty. Built once in SENTENCEG_Init.
+static short grgSentenceHash[SENTENCE_HASH_SIZE];
+static short grgSentenceGroupHash[SENTENCEG_HASH_SIZE];
+
+// sentence names compare case insensitively, group names don't
+static unsigned int USENTENCEG_HashName(const char *szname, int fignorecase)
+{
+	unsigned int hash = 2166136261u;
+
+	while (*szname)
+	{
+		hash ^= fignorecase ? (unsigned char)tolower(*szname) : (unsigned char)*szname;
+		hash *= 16777619u;
+		szname++;
+	}
+
+	return hash;
+}
+
+// first sentence of a name wins, like the linear search did
+
+static void USENTENCEG_HashSentence(int isentence)
+{
+	unsigned int slot = USENTENCEG_HashName(gszallsentencenames[isentence], TRUE) & (SENTENCE_HASH_SIZE - 1);
+	int index;
+
+	while ((index = grgSentenceHash[slot]) != 0)
+	{
+		if (!stricmp(gszallsentencenames[index - 1], gszallsentencenames[isentence]))
+			return;
+
+		slot = (slot + 1) & (SENTENCE_HASH_SIZE - 1);
+	}
+
+	grgSentenceHash[slot] = isentence + 1;
+}
+
+static void USENTENCEG_HashGroup(int isentenceg)
+{
+	unsigned int slot = USENTENCEG_HashName(rgsentenceg[isentenceg].szgroupname, FALSE) & (SENTENCEG_HASH_SIZE - 1);
+	int index;
+
+	while ((index = grgSentenceGroupHash[slot]) != 0)
+	{
+		if (!strcmp(rgsentenceg[index - 1].szgroupname, rgsentenceg[isentenceg].szgroupname))
+			return;
+
+		slot = (slot + 1) & (SENTENCEG_HASH_SIZE - 1);
+	}
+
+	grgSentenceGroupHash[slot] = isentenceg + 1;
+}
+
 // randomize list of sentence name indices
 
 void USENTENCEG_InitLRU(unsigned char *plru, int count)
@@ -1153,19 +1210,21 @@ int USENTENCEG_Pick(int isentenceg, char *szfound)
 
 int SENTENCEG_GetIndex(const char *szgroupname)
 {
-	int i;
+	unsigned int slot;
+	int index;
 
 	if (!fSentencesInit || !szgroupname)
 		return -1;
 
-	// search rgsentenceg for match on szgroupname
+	// search group hash for match on szgroupname
 
-	i = 0;
-	while (rgsentenceg[i].count)
+	slot = USENTENCEG_HashName(szgroupname, FALSE) & (SENTENCEG_HASH_SIZE - 1);
+	while ((index = grgSentenceGroupHash[slot]) != 0)
 	{
-		if (!strcmp(szgroupname, rgsentenceg[i].szgroupname))
-			return i;
-	i++;
+		if (!strcmp(szgroupname, rgsentenceg[index - 1].szgroupname))
+			return index - 1;
+
+		slot = (slot + 1) & (SENTENCEG_HASH_SIZE - 1);
 	}
 
 	return -1;
@@ -1293,6 +1352,8 @@ void SENTENCEG_Init()
 	gcallsentences = 0;
 
 	memset(rgsentenceg, 0, CSENTENCEG_MAX * sizeof(SENTENCEG));
+	memset(grgSentenceHash, 0, sizeof(grgSentenceHash));
+	memset(grgSentenceGroupHash, 0, sizeof(grgSentenceGroupHash));
 	memset(buffer, 0, 512);
 	memset(szgroup, 0, 64);
 	isentencegs = -1;
@@ -1325,7 +1386,7 @@ void SENTENCEG_Init()
 		if (!buffer[j])
 			continue;
 
-		if (gcallsentences > CVOXFILESENTENCEMAX)
+		if (gcallsentences >= CVOXFILESENTENCEMAX)
 		{
 			ALERT (at_error, "Too many sentences in sentences.txt!\n");
 			break;
@@ -1338,7 +1399,8 @@ void SENTENCEG_Init()
 		if ( strlen( pString ) >= CBSENTENCENAME_MAX )
 			ALERT( at_warning, "Sentence %s longer than %d letters\n", pString, CBSENTENCENAME_MAX-1 );
 
-		strcpy( gszallsentencenames[gcallsentences++], pString );
+		strcpy( gszallsentencenames[gcallsentences], pString );
+		USENTENCEG_HashSentence( gcallsentences++ );
 
 		j--;
 		if (j <= i)
@@ -1371,6 +1433,7 @@ void SENTENCEG_Init()
 
 			strcpy(rgsentenceg[isentencegs].szgroupname, &(buffer[i]));
 			rgsentenceg[isentencegs].count = 1;
+			USENTENCEG_HashGroup(isentencegs);
 
 			strcpy(szgroup, &(buffer[i]));
 
@@ -1405,11 +1468,15 @@ void SENTENCEG_Init()
 int SENTENCEG_Lookup(const char *sample, char *sentencenum)
 {
 	char sznum[8];
+	unsigned int slot;
+	int i;
 
-	int i;
 	// this is a sentence name; lookup sentence number
 	// and give to engine as string.
-	for (i = 0; i < gcallsentences; i++)
+	slot = USENTENCEG_HashName(sample+1, TRUE) & (SENTENCE_HASH_SIZE - 1);
+	while ((i = grgSentenceHash[slot]) != 0)
+	{
+		i--;
 		if (!stricmp(gszallsentencenames[i], sample+1))
 		{
 			if (sentencenum)
@@ -1420,10 +1487,80 @@ int SENTENCEG_Lookup(const char *sample, char *sentencenum)
 			}
 			return i;
 		}
+
+		slot = (slot + 1) & (SENTENCE_HASH_SIZE - 1);
+	}
 	// sentence name not found!
 	return -1;
+}
+
+#ifdef _DEBUG
+
+// sentence_bench: time picks by group name, the way monsters speak,
+// against the linear scans the lookups used to be. Picking advances
+// each group's LRU, so it is put back afterwards. Debug builds only.
+
+#include <chrono>
+
+#define SENTENCE_BENCH_MAX	1000000
+
+static SENTENCEG rgsentencegBench[CSENTENCEG_MAX];
+
+void SENTENCEG_Benchmark(int count)
+{
+	char name[64];
+	int groups = 0;
+	int i, j;
+
+	if (!fSentencesInit)
+		return;
+
+	while (groups < CSENTENCEG_MAX && rgsentenceg[groups].count)
+		groups++;
+
+	if (!groups || count <= 0)
+		return;
+
+	if (count > SENTENCE_BENCH_MAX)
+		count = SENTENCE_BENCH_MAX;
+
+	memcpy(rgsentencegBench, rgsentenceg, sizeof(rgsentenceg));
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (i = 0; i < count; i++)
+	{
+		int isentenceg = SENTENCEG_GetIndex(rgsentenceg[i % groups].szgroupname);
+		if (USENTENCEG_Pick(isentenceg, name) >= 0)
+			SENTENCEG_Lookup(name, NULL);
+	}
+
+	auto middle = std::chrono::steady_clock::now();
+
+	for (i = 0; i < count; i++)
+	{
+		const char *szgroupname = rgsentenceg[i % groups].szgroupname;
+		for (j = 0; rgsentenceg[j].count && strcmp(szgroupname, rgsentenceg[j].szgroupname); j++)
+			;
+
+		if (USENTENCEG_Pick(j, name) >= 0)
+		{
+			for (j = 0; j < gcallsentences && stricmp(gszallsentencenames[j], name+1); j++)
+				;
+		}
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	memcpy(rgsentenceg, rgsentencegBench, sizeof(rgsentenceg));
+
+	ALERT(at_console, "%d sentence picks from %d groups: %.2f ms hashed, %.2f ms linear\n", count, groups,
+		std::chrono::duration<double, std::milli>(middle - start).count(),
+		std::chrono::duration<double, std::milli>(end - middle).count());
 }
 
+#endif // _DEBUG
+
 extern cvar_t *g_host_framerate;
 extern cvar_t *g_sys_timescale;
 extern bool using_sys_timescale;
@@ -1535,14 +1672,6 @@ void EMIT_GROUPNAME_SUIT(edict_t *entity, const char *groupname)
 // texture name to a material type.  Play footstep sound based
 // on material type.
 
-int fTextureTypeInit = FALSE;
-
-#define CTEXTURESMAX		512			// max number of textures loaded
-
-int gcTextures = 0;
-char grgszTextureName[CTEXTURESMAX][CBTEXTURENAMEMAX];	// texture names
-char grgchTextureType[CTEXTURESMAX];						// parallel array of texture types
-
 // open materials.txt,  get size, alloc space, 
 // save in array.  Only works first time called, 
 // ignored on subsequent calls.
@@ -1598,66 +1727,23 @@ static char *memfgets( byte *pMemFile, int fileSize, int &filePos, char *pBuffer
 
 void TEXTURETYPE_Init()
 {
-	char buffer[512];
-	int i, j;
 	byte *pMemFile;
-	int fileSize, filePos = 0;
+	int fileSize;
 
-	if (fTextureTypeInit)
+	// Texture names of the previous map are gone
+	PM_ClearMaterialCache();
+
+	if ( PM_MaterialsInitialized() )
 		return;
 
-	memset(&(grgszTextureName[0][0]), 0, CTEXTURESMAX * CBTEXTURENAMEMAX);
-	memset(grgchTextureType, 0, CTEXTURESMAX);
-
-	gcTextures = 0;
-	memset(buffer, 0, 512);
-
 	pMemFile = g_engfuncs.pfnLoadFileForMe( "sound/materials.txt", &fileSize );
 	if ( !pMemFile )
 		return;
 
-	// for each line in the file...
-	while (memfgets(pMemFile, fileSize, filePos, buffer, 511) != NULL && (gcTextures < CTEXTURESMAX))
-	{
-		// skip whitespace
-		i = 0;
-		while(buffer[i] && isspace(buffer[i]))
-			i++;
-		
-		if (!buffer[i])
-			continue;
-
-		// skip comment lines
-		if (buffer[i] == '/' || !isalpha(buffer[i]))
-			continue;
-
-		// get texture type
-		grgchTextureType[gcTextures] = toupper(buffer[i++]);
-
-		// skip whitespace
-		while(buffer[i] && isspace(buffer[i]))
-			i++;
-		
-		if (!buffer[i])
-			continue;
-
-		// get sentence name
-		j = i;
-		while (buffer[j] && !isspace(buffer[j]))
-			j++;
-
-		if (!buffer[j])
-			continue;
-
-		// null-terminate name and save in sentences array
-		j = min (j, CBTEXTURENAMEMAX-1+i);
-		buffer[j] = 0;
-		strcpy(&(grgszTextureName[gcTextures++][0]), &(buffer[i]));
-	}
+	// Table is shared with player movement, see pm_materials.c
+	PM_InitMaterials( pMemFile, fileSize );
 
 	g_engfuncs.pfnFreeFile( pMemFile );
-	
-	fTextureTypeInit = TRUE;
 }
 
 // given texture name, find texture type
@@ -1668,15 +1754,7 @@ void TEXTURETYPE_Init()
 
 char TEXTURETYPE_Find(char *name)
 {
-	// CONSIDER: pre-sort texture names and perform faster binary search here
-
-	for (int i = 0; i < gcTextures; i++)
-	{
-		if (!strnicmp(name, &(grgszTextureName[i][0]), CBTEXTURENAMEMAX-1))
-			return (grgchTextureType[i]);
-	}
-
-	return CHAR_TEX_CONCRETE;
+	return PM_FindMaterial( name );
 }
 
 // play a strike sound based on the texture that was hit by the attack traceline.  VecSrc/VecEnd are the
@@ -1690,7 +1768,6 @@ float TEXTURETYPE_PlaySound(TraceResult *ptr,  Vector vecSrc, Vector vecEnd, int
 	char chTextureType;
 	float fvol;
 	float fvolbar;
-	char szbuffer[64];
 	const char *pTextureName;
 	float rgfl1[3];
 	float rgfl2[3];
@@ -1727,20 +1804,10 @@ float TEXTURETYPE_PlaySound(TraceResult *ptr,  Vector vecSrc, Vector vecEnd, int
 			
 		if ( pTextureName )
 		{
-			// strip leading '-0' or '+0~' or '{' or '!'
-			if (*pTextureName == '-' || *pTextureName == '+')
-				pTextureName += 2;
-
-			if (*pTextureName == '{' || *pTextureName == '!' || *pTextureName == '~' || *pTextureName == ' ')
-				pTextureName++;
-			// '}}'
-			strcpy(szbuffer, pTextureName);
-			szbuffer[CBTEXTURENAMEMAX - 1] = 0;
-				
-			// ALERT ( at_console, "texture hit: %s\n", szbuffer);
+			// ALERT ( at_console, "texture hit: %s\n", pTextureName);
 
-			// get texture type
-			chTextureType = TEXTURETYPE_Find(szbuffer);	
+			// get texture type, cached per texture of the map
+			chTextureType = PM_TextureMaterial(pTextureName);
 		}
 	}
 
@@ -34,6 +34,7 @@ void CSound :: Clear ( void )
 	m_flExpireTime	= 0;
 	m_iNext			= SOUNDLIST_EMPTY;
 	m_iNextAudible	= 0;
+	m_iNextInCell	= SOUNDLIST_EMPTY;
 }
 
 //=========================================================
@@ -94,6 +95,7 @@ void CSoundEnt :: Think ( void )
 {
 	int iSound;
 	int iPreviousSound;
+	BOOL fFreed = FALSE;
 
 	pev->nextthink = gpGlobals->time + 0.3;// how often to check the sound list.
 
@@ -108,6 +110,7 @@ void CSoundEnt :: Think ( void )
 
 			// move this sound back into the free list
 			FreeSound( iSound, iPreviousSound );
+			fFreed = TRUE;
 
 			iSound = iNext;
 		}
@@ -118,9 +121,15 @@ void CSoundEnt :: Think ( void )
 		}
 	}
 
+	// freed sounds are still linked into their cells
+	if ( fFreed )
+	{
+		RebuildGrid();
+	}
+
 	if ( m_fShowReport )
 	{
-		ALERT ( at_aiconsole, "Soundlist: %d / %d  (%d)\n", ISoundsInList( SOUNDLISTTYPE_ACTIVE ),ISoundsInList( SOUNDLISTTYPE_FREE ), ISoundsInList( SOUNDLISTTYPE_ACTIVE ) - m_cLastActiveSounds );
+		ALERT ( at_aiconsole, "Soundlist: %d / %d  (%d) in %d cells\n", ISoundsInList( SOUNDLISTTYPE_ACTIVE ),ISoundsInList( SOUNDLISTTYPE_FREE ), ISoundsInList( SOUNDLISTTYPE_ACTIVE ) - m_cLastActiveSounds, m_cOccupiedCells );
 		m_cLastActiveSounds = ISoundsInList ( SOUNDLISTTYPE_ACTIVE );
 	}
 
@@ -219,6 +228,78 @@ void CSoundEnt :: InsertSound ( int iType, const Vector &vecOrigin, int iVolume,
 	pSoundEnt->m_SoundPool[ iThisSound ].m_iType = iType;
 	pSoundEnt->m_SoundPool[ iThisSound ].m_iVolume = iVolume;
 	pSoundEnt->m_SoundPool[ iThisSound ].m_flExpireTime = gpGlobals->time + flDuration;
+
+	pSoundEnt->LinkSound( iThisSound );
+}
+
+//=========================================================
+// SoundGridCell - returns the grid cell for an origin.
+// Origins outside the grid go in the cells on its edge.
+//=========================================================
+static int SoundGridCell ( const Vector &vecOrigin )
+{
+	int x = (int)floor( vecOrigin.x / SOUNDGRID_CELL_SIZE ) + SOUNDGRID_SIZE / 2;
+	int y = (int)floor( vecOrigin.y / SOUNDGRID_CELL_SIZE ) + SOUNDGRID_SIZE / 2;
+
+	x = max( 0, min( x, SOUNDGRID_SIZE - 1 ) );
+	y = max( 0, min( y, SOUNDGRID_SIZE - 1 ) );
+
+	return y * SOUNDGRID_SIZE + x;
+}
+
+//=========================================================
+// LinkSound - puts an active sound at the head of the
+// list for its grid cell, and grows the cell's bounds
+// and volume to cover it.
+//=========================================================
+void CSoundEnt :: LinkSound ( int iSound )
+{
+	CSound *pSound = &m_SoundPool[ iSound ];
+	int iCell = SoundGridCell( pSound->m_vecOrigin );
+
+	if ( m_iCellHead[ iCell ] == SOUNDLIST_EMPTY )
+	{
+		m_iOccupiedCells[ m_cOccupiedCells++ ] = iCell;
+		m_iCellVolume[ iCell ] = pSound->m_iVolume;
+		m_vecCellMins[ iCell ] = pSound->m_vecOrigin;
+		m_vecCellMaxs[ iCell ] = pSound->m_vecOrigin;
+	}
+	else
+	{
+		m_iCellVolume[ iCell ] = max( m_iCellVolume[ iCell ], pSound->m_iVolume );
+		for ( int i = 0 ; i < 3 ; i++ )
+		{
+			m_vecCellMins[ iCell ][ i ] = min( m_vecCellMins[ iCell ][ i ], pSound->m_vecOrigin[ i ] );
+			m_vecCellMaxs[ iCell ][ i ] = max( m_vecCellMaxs[ iCell ][ i ], pSound->m_vecOrigin[ i ] );
+		}
+	}
+
+	pSound->m_iNextInCell = m_iCellHead[ iCell ];
+	m_iCellHead[ iCell ] = iSound;
+}
+
+//=========================================================
+// RebuildGrid - empties the grid and links every active
+// sound back into it, except the client reserved sounds.
+//=========================================================
+void CSoundEnt :: RebuildGrid ( void )
+{
+	int i;
+	int iSound;
+
+	for ( i = 0 ; i < m_cOccupiedCells ; i++ )
+	{
+		m_iCellHead[ m_iOccupiedCells[ i ] ] = SOUNDLIST_EMPTY;
+	}
+	m_cOccupiedCells = 0;
+
+	for ( iSound = m_iActiveSound ; iSound != SOUNDLIST_EMPTY ; iSound = m_SoundPool[ iSound ].m_iNext )
+	{
+		if ( iSound >= m_cReservedSounds )
+		{
+			LinkSound( iSound );
+		}
+	}
 }
 
 //=========================================================
@@ -233,6 +314,13 @@ void CSoundEnt :: Initialize ( void )
 	m_cLastActiveSounds;
 	m_iFreeSound = 0;
 	m_iActiveSound = SOUNDLIST_EMPTY;
+	m_cReservedSounds = 0;
+
+	for ( i = 0 ; i < SOUNDGRID_CELLS ; i++ )
+	{
+		m_iCellHead[ i ] = SOUNDLIST_EMPTY;
+	}
+	m_cOccupiedCells = 0;
 
 	for ( i = 0 ; i < MAX_WORLD_SOUNDS ; i++ )
 	{// clear all sounds, and link them into the free sound list.
@@ -255,6 +343,9 @@ void CSoundEnt :: Initialize ( void )
 		}
 
 		pSoundEnt->m_SoundPool[ iSound ].m_flExpireTime = SOUND_NEVER_EXPIRE;
+
+		// reserved sounds come off the front of the free list, so they are 0 to maxClients - 1
+		m_cReservedSounds = iSound + 1;
 	}
 
 	if ( CVAR_GET_FLOAT("displaysoundlist") == 1 )
@@ -376,4 +467,65 @@ int CSoundEnt :: ClientSoundIndex ( edict_t *pClient )
 #endif // _DEBUG
 
 	return iReturn;
-}
\ No newline at end of file
+}
+
+//=========================================================
+// AudibleList - links together every sound of the given
+// types that is close enough to be heard at vecEar through
+// m_iNextAudible, and returns the first one. Only the grid
+// cells loud enough to reach vecEar are searched.
+//=========================================================
+int CSoundEnt :: AudibleList ( const Vector &vecEar, int iSoundMask, float flSensitivity )
+{
+	int i, j;
+	int iSound;
+	int iCell;
+	int iAudibleList = SOUNDLIST_EMPTY;
+	CSound *pSound;
+	Vector vecClosest;
+
+	if ( !pSoundEnt )
+	{
+		return SOUNDLIST_EMPTY;
+	}
+
+	for ( iSound = 0 ; iSound < pSoundEnt->m_cReservedSounds ; iSound++ )
+	{
+		pSound = &pSoundEnt->m_SoundPool[ iSound ];
+
+		if ( ( pSound->m_iType & iSoundMask ) && ( pSound->m_vecOrigin - vecEar ).Length() <= pSound->m_iVolume * flSensitivity )
+		{
+			pSound->m_iNextAudible = iAudibleList;
+			iAudibleList = iSound;
+		}
+	}
+
+	for ( i = 0 ; i < pSoundEnt->m_cOccupiedCells ; i++ )
+	{
+		iCell = pSoundEnt->m_iOccupiedCells[ i ];
+
+		// nearest point of the cell's bounds, no sound in it is closer than this
+		for ( j = 0 ; j < 3 ; j++ )
+		{
+			vecClosest[ j ] = max( pSoundEnt->m_vecCellMins[ iCell ][ j ], min( vecEar[ j ], pSoundEnt->m_vecCellMaxs[ iCell ][ j ] ) );
+		}
+
+		if ( ( vecClosest - vecEar ).Length() > pSoundEnt->m_iCellVolume[ iCell ] * flSensitivity )
+		{
+			continue;
+		}
+
+		for ( iSound = pSoundEnt->m_iCellHead[ iCell ] ; iSound != SOUNDLIST_EMPTY ; iSound = pSound->m_iNextInCell )
+		{
+			pSound = &pSoundEnt->m_SoundPool[ iSound ];
+
+			if ( ( pSound->m_iType & iSoundMask ) && ( pSound->m_vecOrigin - vecEar ).Length() <= pSound->m_iVolume * flSensitivity )
+			{
+				pSound->m_iNextAudible = iAudibleList;
+				iAudibleList = iSound;
+			}
+		}
+	}
+
+	return iAudibleList;
+}
@@ -18,7 +18,13 @@
 // lists.
 //=========================================================
 
-#define	MAX_WORLD_SOUNDS	64 // maximum number of sounds handled by the world at one time.
+#define	MAX_WORLD_SOUNDS	1024 // maximum number of sounds handled by the world at one time.
+
+// Active sounds are also bucketed by origin in a grid of columns, so
+// a monster only looks at sounds in cells that are loud enough to reach it.
+#define SOUNDGRID_CELL_SIZE	512
+#define SOUNDGRID_SIZE		16	// cells across, covers -4096 to 4096
+#define SOUNDGRID_CELLS		( SOUNDGRID_SIZE * SOUNDGRID_SIZE )
 
 #define bits_SOUND_NONE		0
 #define	bits_SOUND_COMBAT	( 1 << 0 )// gunshots, explosions
@@ -54,6 +60,7 @@ public:
 	float	m_flExpireTime;	// when the sound should be purged from the list
 	int		m_iNext;		// index of next sound in this list ( Active or Free )
 	int		m_iNextAudible;	// temporary link that monsters use to build a list of audible sounds
+	int		m_iNextInCell;	// next sound in the same grid cell
 
 	BOOL	FIsSound( void );
 	BOOL	FIsScent( void );
@@ -79,10 +86,13 @@ public:
 	static int		FreeList( void );// return the head of the free list
 	static CSound*	SoundPointerForIndex( int iIndex );// return a pointer for this index in the sound list
 	static int		ClientSoundIndex ( edict_t *pClient );
+	static int		AudibleList ( const Vector &vecEar, int iSoundMask, float flSensitivity );// link the sounds heard at vecEar, return the head
 
 	BOOL	IsEmpty( void ) { return m_iActiveSound == SOUNDLIST_EMPTY; }
 	int		ISoundsInList ( int iListType );
 	int		IAllocSound ( void );
+	void	LinkSound ( int iSound );
+	void	RebuildGrid ( void );
 	virtual int		ObjectCaps( void ) { return FCAP_DONT_SAVE; }
 	
 	int		m_iFreeSound;	// index of the first sound in the free sound list
@@ -92,4 +102,14 @@ public:
 
 private:
 	CSound		m_SoundPool[ MAX_WORLD_SOUNDS ];
+
+	// Client reserved sounds move every frame, so they are never put in the grid
+	int			m_cReservedSounds;
+
+	int			m_iCellHead[ SOUNDGRID_CELLS ];			// first sound in each cell
+	int			m_iCellVolume[ SOUNDGRID_CELLS ];		// loudest sound in each cell
+	Vector		m_vecCellMins[ SOUNDGRID_CELLS ];		// bounds of the sound origins in each cell
+	Vector		m_vecCellMaxs[ SOUNDGRID_CELLS ];
+	int			m_iOccupiedCells[ SOUNDGRID_CELLS ];	// cells with sounds in them
+	int			m_cOccupiedCells;
 };
@@ -160,6 +160,7 @@ void CTripmineGrenade::Use( CBaseEntity *pActivator, CBaseEntity *pCaller, USE_T
 	if ( CHalfLifeRules *rules = dynamic_cast< CHalfLifeRules * >( g_pGameRules ) ) {
 		if ( std::string( STRING( pev->targetname ) ).empty() ) {
 			pev->targetname = MAKE_STRING( "detached_tripmine" );
+			UTIL_EntityNameChanged( edict() );
 		}
 		rules->HookModelIndex( edict() );
 	}
@@ -388,6 +389,7 @@ void CTripmineGrenade::DelayDeathThink( void )
 	if ( CHalfLifeRules *rules = dynamic_cast< CHalfLifeRules * >( g_pGameRules ) ) {
 		if ( std::string( STRING( pev->targetname ) ).empty() ) {
 			pev->targetname = MAKE_STRING( "destroyed_tripmine" );
+			UTIL_EntityNameChanged( edict() );
 		}
 		rules->HookModelIndex( edict() );
 	}
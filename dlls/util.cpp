@@ -30,6 +30,13 @@
 #include "player.h"
 #include "weapons.h"
 #include "gamerules.h"
+#include "game.h"
+#include "precache.h"
+#include <string>
+#include <set>
+#include <vector>
+#include <unordered_set>
+#include <unordered_map>
 
 float UTIL_WeaponTimeBase( void )
 {
@@ -547,6 +554,239 @@ CBaseEntity *UTIL_FindEntityInSphere( CBaseEntity *pStartEntity, const Vector &v
 }
 
 
+//=========================================================
+// Entity name index
+//
+// Sorted edict numbers of every classname and targetname, so
+// lookups only visit matching edicts, in the same order the
+// engine's FIND_ENTITY_BY_STRING scan would return them.
+// Each edict remembers the names it was indexed under. Edicts
+// whose names may have changed stay queued until the next
+// frame and are checked against those before every lookup,
+// and StartFrame checks every edict, so a rename nobody
+// reported is picked up within a frame.
+//=========================================================
+typedef std::unordered_map<std::string, std::set<int>> entitynamemap_t;
+
+typedef struct
+{
+	std::set<int>	*pClassname;
+	std::set<int>	*pTargetname;
+	string_t		classname;		// names the edict is indexed under
+	string_t		targetname;
+	BOOL			fQueued;
+} entitynames_t;
+
+static entitynamemap_t				g_ClassnameIndex;
+static entitynamemap_t				g_TargetnameIndex;
+static std::vector<entitynames_t>	g_EntityNames;
+static std::vector<int>				g_EntityNamesChanged;
+static BOOL							g_fEntityIndexValid = FALSE;
+
+static int g_iEntityIndexLookups = 0;
+static int g_iEntityIndexScanned = 0;
+
+static void UTIL_IndexEntityName( entitynamemap_t &index, std::set<int> *&pSet, int entityIndex, string_t name )
+{
+	const char *pszName = name ? STRING( name ) : NULL;
+
+	if ( pSet )
+	{
+		pSet->erase( entityIndex );
+		pSet = NULL;
+	}
+
+	// FIND_ENTITY_BY_STRING never matches empty names
+	if ( pszName && *pszName )
+	{
+		pSet = &index[pszName];
+		pSet->insert( entityIndex );
+	}
+}
+
+static void UTIL_IndexEntity( edict_t *pEdictList, int entityIndex )
+{
+	if ( entityIndex < 0 || entityIndex >= (int)g_EntityNames.size() )
+		return;
+
+	edict_t *pent = pEdictList + entityIndex;
+	entitynames_t &names = g_EntityNames[entityIndex];
+
+	names.classname = pent->free ? 0 : pent->v.classname;
+	names.targetname = pent->free ? 0 : pent->v.targetname;
+
+	UTIL_IndexEntityName( g_ClassnameIndex, names.pClassname, entityIndex, names.classname );
+	UTIL_IndexEntityName( g_TargetnameIndex, names.pTargetname, entityIndex, names.targetname );
+}
+
+// Reindexes the edict if its names aren't the ones it's indexed under
+static void UTIL_RevalidateEntity( edict_t *pEdictList, int entityIndex )
+{
+	edict_t *pent = pEdictList + entityIndex;
+	const entitynames_t &names = g_EntityNames[entityIndex];
+
+	if ( names.classname != ( pent->free ? 0 : pent->v.classname ) ||
+		 names.targetname != ( pent->free ? 0 : pent->v.targetname ) )
+	{
+		UTIL_IndexEntity( pEdictList, entityIndex );
+	}
+}
+
+//=========================================================
+// Drops the index, it's rebuilt from all edicts on the next
+// lookup. Called when a map starts.
+//=========================================================
+void UTIL_ClearEntityIndex( void )
+{
+	g_ClassnameIndex.clear();
+	g_TargetnameIndex.clear();
+	g_EntityNames.clear();
+	g_EntityNamesChanged.clear();
+	g_fEntityIndexValid = FALSE;
+}
+
+//=========================================================
+// Queues an edict to be checked before every lookup until
+// the next frame. Every entity comes through here when its
+// private data is allocated, code that renames an entity
+// after it spawned has to call it as well.
+//=========================================================
+void UTIL_EntityNameChanged( edict_t *pent )
+{
+	if ( !g_fEntityIndexValid || !pent )
+		return;
+
+	int entityIndex = ENTINDEX( pent );
+	if ( entityIndex < 0 || entityIndex >= (int)g_EntityNames.size() || g_EntityNames[entityIndex].fQueued )
+		return;
+
+	// Rebuilding is cheaper by then
+	if ( (int)g_EntityNamesChanged.size() >= gpGlobals->maxEntities / 4 )
+	{
+		UTIL_ClearEntityIndex();
+		return;
+	}
+
+	g_EntityNames[entityIndex].fQueued = TRUE;
+	g_EntityNamesChanged.push_back( entityIndex );
+}
+
+//=========================================================
+// Checks every edict against the names it's indexed under
+// and empties the queue. Called at the start of each frame.
+//=========================================================
+void UTIL_RevalidateEntityIndex( void )
+{
+	if ( !g_fEntityIndexValid )
+		return;
+
+	edict_t *pEdictList = INDEXENT( 0 );
+
+	for ( int i = 1; i < gpGlobals->maxEntities; i++ )
+	{
+		UTIL_RevalidateEntity( pEdictList, i );
+		g_EntityNames[i].fQueued = FALSE;
+	}
+
+	g_EntityNamesChanged.clear();
+}
+
+static edict_t *UTIL_UpdateEntityIndex( void )
+{
+	edict_t *pEdictList = INDEXENT( 0 );
+
+	if ( !g_fEntityIndexValid )
+	{
+		entitynames_t empty = { NULL, NULL, 0, 0, FALSE };
+
+		g_EntityNames.assign( gpGlobals->maxEntities, empty );
+		g_EntityNamesChanged.clear();
+
+		for ( int i = 1; i < gpGlobals->maxEntities; i++ )
+		{
+			UTIL_IndexEntity( pEdictList, i );
+		}
+
+		g_iEntityIndexScanned += gpGlobals->maxEntities;
+		g_fEntityIndexValid = TRUE;
+	}
+	else
+	{
+		// Queued edicts may be named after the last lookup, so the queue is kept
+		for ( size_t i = 0; i < g_EntityNamesChanged.size(); i++ )
+		{
+			UTIL_RevalidateEntity( pEdictList, g_EntityNamesChanged[i] );
+		}
+
+		g_iEntityIndexScanned += g_EntityNamesChanged.size();
+	}
+
+	return pEdictList;
+}
+
+//=========================================================
+// Same result as FIND_ENTITY_BY_STRING on "classname" or
+// "targetname", including the world edict when nothing is found
+//=========================================================
+edict_t *UTIL_FindEdictByName( edict_t *pentStart, const char *pszName, int fTargetname )
+{
+	edict_t *pEdictList = UTIL_UpdateEntityIndex();
+	edict_t *pentFound = pEdictList;
+
+	g_iEntityIndexLookups++;
+
+	entitynamemap_t &index = fTargetname ? g_TargetnameIndex : g_ClassnameIndex;
+	entitynamemap_t::iterator it = pszName ? index.find( pszName ) : index.end();
+
+	if ( it != index.end() )
+	{
+		std::set<int> &entities = it->second;
+		std::set<int>::iterator entity = entities.upper_bound( pentStart ? (int)( pentStart - pEdictList ) : 0 );
+
+		while ( entity != entities.end() )
+		{
+			edict_t *pent = pEdictList + *entity++;
+			string_t name = fTargetname ? pent->v.targetname : pent->v.classname;
+
+			g_iEntityIndexScanned++;
+
+			if ( !pent->free && name && !strcmp( STRING( name ), pszName ) )
+			{
+				pentFound = pent;
+				break;
+			}
+
+			// Renamed or freed behind our back, the iterator already moved past it
+			UTIL_IndexEntity( pEdictList, (int)( pent - pEdictList ) );
+		}
+	}
+
+	if ( entindex_debug.value >= 2 )
+	{
+		edict_t *pentScan = FIND_ENTITY_BY_STRING( pentStart, fTargetname ? "targetname" : "classname", pszName );
+		if ( pentScan != pentFound )
+		{
+			ALERT( at_console, "Entity index: %s \"%s\" after %d gave %d, full scan gave %d\n", fTargetname ? "targetname" : "classname",
+				pszName, pentStart ? ENTINDEX( pentStart ) : 0, ENTINDEX( pentFound ), ENTINDEX( pentScan ) );
+			pentFound = pentScan;
+		}
+	}
+
+	return pentFound;
+}
+
+//=========================================================
+// Lookups and edicts checked since the last call
+//=========================================================
+void UTIL_EntityIndexStats( int *pLookups, int *pScanned )
+{
+	*pLookups = g_iEntityIndexLookups;
+	*pScanned = g_iEntityIndexScanned;
+
+	g_iEntityIndexLookups = 0;
+	g_iEntityIndexScanned = 0;
+}
+
 CBaseEntity *UTIL_FindEntityByString( CBaseEntity *pStartEntity, const char *szKeyword, const char *szValue )
 {
 	edict_t	*pentEntity;
@@ -556,7 +796,12 @@ CBaseEntity *UTIL_FindEntityByString( CBaseEntity *pStartEntity, const char *szK
 	else
 		pentEntity = NULL;
 
-	pentEntity = FIND_ENTITY_BY_STRING( pentEntity, szKeyword, szValue );
+	if ( FStrEq( szKeyword, "classname" ) )
+		pentEntity = UTIL_FindEdictByName( pentEntity, szValue, FALSE );
+	else if ( FStrEq( szKeyword, "targetname" ) )
+		pentEntity = UTIL_FindEdictByName( pentEntity, szValue, TRUE );
+	else
+		pentEntity = FIND_ENTITY_BY_STRING( pentEntity, szKeyword, szValue );
 
 	if (!FNullEnt(pentEntity))
 		return CBaseEntity::Instance(pentEntity);
@@ -1133,6 +1378,53 @@ char* UTIL_VarArgs( char *format, ... )
 	va_end (argptr);
 
 	return string;	
+}
+
+// Interned strings, kept for the lifetime of the DLL. Nodes of unordered_set
+// don't move, so the string_t handed out for a string stays valid.
+static std::unordered_set<std::string> g_StringPool;
+static int g_iStringPoolBytes = 0;
+
+//=========================================================
+// UTIL_AllocPooledString - ALLOC_STRING for strings made at
+// runtime. Every ALLOC_STRING call takes new memory from the
+// engine's string heap, this returns the same string_t again
+// for a string that was seen before.
+//=========================================================
+string_t UTIL_AllocPooledString( const char *pszValue )
+{
+	// Same escape handling as the engine's ALLOC_STRING: \n becomes
+	// a newline, any other escaped character is dropped
+	std::string value;
+	int length = strlen( pszValue );
+	value.reserve( length );
+
+	for ( int i = 0; i < length; i++ )
+	{
+		if ( pszValue[i] == '\\' && i < length - 1 )
+		{
+			i++;
+			value += pszValue[i] == 'n' ? '\n' : '\\';
+		}
+		else
+		{
+			value += pszValue[i];
+		}
+	}
+
+	auto inserted = g_StringPool.insert( value );
+	if ( inserted.second )
+	{
+		g_iStringPoolBytes += inserted.first->size() + 1;
+	}
+
+	return MAKE_STRING( inserted.first->c_str() );
+}
+
+void UTIL_PooledStringStats( int *pCount, int *pBytes )
+{
+	*pCount = g_StringPool.size();
+	*pBytes = g_iStringPoolBytes;
 }
 	
 Vector UTIL_GetAimVector( edict_t *pent, float flSpeed )
@@ -1634,6 +1926,9 @@ void UTIL_PrecacheOther( const char *szClassname )
 {
 	edict_t	*pent;
 
+	if ( !UTIL_FirstPrecacheOther( szClassname ) )
+		return;
+
 	pent = CREATE_NAMED_ENTITY( MAKE_STRING( szClassname ) );
 	if ( FNullEnt( pent ) )
 	{
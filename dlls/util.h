@@ -33,18 +33,26 @@ inline void MESSAGE_BEGIN( int msg_dest, int msg_type, const float *pOrigin, ent
 
 extern globalvars_t				*gpGlobals;
 
-// Use this instead of ALLOC_STRING on constant strings
+// Use this instead of ALLOC_STRING on constant strings,
+// use UTIL_AllocPooledString for strings built at runtime
 #define STRING(offset)		((const char *)(gpGlobals->pStringBase + (unsigned int)(offset)))
 #define MAKE_STRING(str)	((uint64)(str) - (uint64)(STRING(0)))
 
+// Classname and targetname lookups go through the DLL's entity name index
+extern edict_t *UTIL_FindEdictByName( edict_t *pentStart, const char *pszName, int fTargetname );
+extern void UTIL_EntityNameChanged( edict_t *pent );
+extern void UTIL_ClearEntityIndex( void );
+extern void UTIL_RevalidateEntityIndex( void );
+extern void UTIL_EntityIndexStats( int *pLookups, int *pScanned );
+
 inline edict_t *FIND_ENTITY_BY_CLASSNAME(edict_t *entStart, const char *pszName) 
 {
-	return FIND_ENTITY_BY_STRING(entStart, "classname", pszName);
+	return UTIL_FindEdictByName(entStart, pszName, FALSE);
 }	
 
 inline edict_t *FIND_ENTITY_BY_TARGETNAME(edict_t *entStart, const char *pszName) 
 {
-	return FIND_ENTITY_BY_STRING(entStart, "targetname", pszName);
+	return UTIL_FindEdictByName(entStart, pszName, TRUE);
 }	
 
 // for doing a reverse lookup. Say you have a door, and want to find its button.
@@ -317,6 +325,8 @@ extern float		UTIL_ApproachAngle( float target, float value, float speed );
 extern float		UTIL_AngleDistance( float next, float cur );
 
 extern char			*UTIL_VarArgs( char *format, ... );
+extern string_t		UTIL_AllocPooledString( const char *pszValue );
+extern void			UTIL_PooledStringStats( int *pCount, int *pBytes );
 extern void			UTIL_Remove( CBaseEntity *pEntity );
 extern BOOL			UTIL_IsValidEntity( edict_t *pent );
 extern BOOL			UTIL_TeamsMatch( const char *pTeamName1, const char *pTeamName2 );
@@ -526,6 +536,9 @@ int SENTENCEG_PlayRndSz(edict_t *entity, const char *szrootname, float volume, f
 int SENTENCEG_PlaySequentialSz(edict_t *entity, const char *szrootname, float volume, float attenuation, int flags, int pitch, int ipick, int freset);
 int SENTENCEG_GetIndex(const char *szrootname);
 int SENTENCEG_Lookup(const char *sample, char *sentencenum);
+#ifdef _DEBUG
+void SENTENCEG_Benchmark(int count);
+#endif
 
 void TEXTURETYPE_Init();
 char TEXTURETYPE_Find(char *name);
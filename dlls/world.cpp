@@ -32,6 +32,7 @@
 #include "player.h"
 #include "weapons.h"
 #include "gamerules.h"
+#include "precache.h"
 #include "teamplay_gamerules.h"
 #include "cgm_gamerules.h"
 #include "gameplay_mod.h"
@@ -516,6 +517,17 @@ void CWorld :: Precache( void )
 
 	g_changeLevelOccured = 0;
 
+	// Runtime strings survive level changes, report how far the pool has grown during long sessions
+	int pooledStrings, pooledStringBytes;
+	UTIL_PooledStringStats( &pooledStrings, &pooledStringBytes );
+	ALERT( at_aiconsole, "Pooled strings: %d ( %d bytes )\n", pooledStrings, pooledStringBytes );
+
+	// Entity name index still points at edicts of the previous map
+	UTIL_ClearEntityIndex();
+
+	// Precache registry and manifest start over for this map
+	UTIL_ResetPrecache();
+
 	//!!!UNDONE why is there so much Spawn code in the Precache function? I'll just keep it here 
 
 	///!!!LATER - do we want a sound ent in deathmatch? (sjb)
@@ -688,7 +700,10 @@ void CWorld :: Precache( void )
 
 	if ( CHalfLifeRules *singlePlayerRules = dynamic_cast< CHalfLifeRules * >( g_pGameRules ) ) {
 		singlePlayerRules->OnChangeLevel();
+		UTIL_LoadPrecacheManifest( singlePlayerRules->GetPrecacheManifestName().c_str() );
 		singlePlayerRules->Precache();
+	} else {
+		UTIL_LoadPrecacheManifest( STRING( gpGlobals->mapname ) );
 	}
 }
 
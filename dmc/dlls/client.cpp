@@ -650,6 +650,8 @@ void StartFrame( void )
 	gpGlobals->teamplay = CVAR_GET_FLOAT("teamplay");
 	g_iSkillLevel = CVAR_GET_FLOAT("skill");
 	g_ulFrameCount++;
+
+	Q_NailFrame();
 }
 
 
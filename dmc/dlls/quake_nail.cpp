@@ -5,7 +5,7 @@
 // Valve, L.L.C., or in accordance with the terms and conditions stipulated in
 // the agreement/contract under which the contents have been supplied.
 //
-// Purpose: Quake nail entity
+// Purpose: Quake nails
 //
 // $Workfile:     $
 // $Date:         $
@@ -25,98 +25,176 @@
 
 LINK_ENTITY_TO_CLASS( quake_nail, CQuakeNail );
 
-//=========================================================
-CQuakeNail *CQuakeNail::CreateNail( Vector vecOrigin, Vector vecAngles, CBaseEntity *pOwner )
+// Nails aren't entities. They're kept here and moved all at once each frame
+// with a trace from where they were, which is what the engine's missile
+// physics did for a nail entity. Clients draw their own nails from the
+// nailgun events, so there's nothing to send either.
+#define MAX_FLYING_NAILS	1024
+
+typedef struct
 {
-	CQuakeNail *pNail = GetClassPtr( (CQuakeNail *)NULL );
+	Vector	origin;
+	Vector	velocity;
+	EHANDLE	hOwner;
+	float	flMoveTime;		// time the nail is at origin
+	float	flRemoveTime;	// safety removal
+	BOOL	fSuper;
+} flyingnail_t;
 
-	UTIL_SetOrigin( pNail->pev, vecOrigin );
+static flyingnail_t g_rgFlyingNails[MAX_FLYING_NAILS];
+static int g_iFlyingNails = 0;
 
-	pNail->pev->velocity = vecAngles * 1000;
-	pNail->pev->angles = UTIL_VecToAngles(vecAngles);
-	pNail->pev->owner = pOwner->edict();
-	pNail->Spawn();
-	pNail->pev->classname = MAKE_STRING("spike");
+// Nail damage is dealt by one of these, so kill messages still read spike or superspike
+static EHANDLE g_hNailInflictors[2];
 
-	// don't send to clients.
-	pNail->pev->effects |= EF_NODRAW;
+//=========================================================
+static void AddFlyingNail( Vector vecOrigin, Vector vecVelocity, CBaseEntity *pOwner, BOOL fSuper )
+{
+	flyingnail_t *pNail;
 
-	return pNail;
+	if ( g_iFlyingNails < MAX_FLYING_NAILS )
+	{
+		pNail = &g_rgFlyingNails[g_iFlyingNails++];
+	}
+	else
+	{
+		// Full, take over the nail closest to its safety removal
+		pNail = &g_rgFlyingNails[0];
+		for ( int i = 1; i < g_iFlyingNails; i++ )
+		{
+			if ( g_rgFlyingNails[i].flRemoveTime < pNail->flRemoveTime )
+				pNail = &g_rgFlyingNails[i];
+		}
+	}
+
+	pNail->origin = vecOrigin;
+	pNail->velocity = vecVelocity;
+	pNail->hOwner = pOwner;
+	pNail->flMoveTime = gpGlobals->time;
+	pNail->flRemoveTime = gpGlobals->time + 6;
+	pNail->fSuper = fSuper;
 }
 
-CQuakeNail *CQuakeNail::CreateSuperNail( Vector vecOrigin, Vector vecAngles, CBaseEntity *pOwner )
+//=========================================================
+void CQuakeNail::CreateNail( Vector vecOrigin, Vector vecAngles, CBaseEntity *pOwner )
 {
-	CQuakeNail *pNail = CreateNail( vecOrigin, vecAngles, pOwner );
-	pNail->pev->classname = MAKE_STRING("superspike");
+	AddFlyingNail( vecOrigin, vecAngles * 1000, pOwner, FALSE );
+}
 
+void CQuakeNail::CreateSuperNail( Vector vecOrigin, Vector vecAngles, CBaseEntity *pOwner )
+{
 	// Super nails simply do more damage
-	pNail->pev->dmg = 18;
-	return pNail;
+	AddFlyingNail( vecOrigin, vecAngles * 1000, pOwner, TRUE );
+}
+
+//=========================================================
+CQuakeNail *CQuakeNail::Inflictor( BOOL fSuper )
+{
+	EHANDLE &hInflictor = g_hNailInflictors[fSuper ? 1 : 0];
+
+	if ( hInflictor == NULL )
+	{
+		CQuakeNail *pNail = GetClassPtr( (CQuakeNail *)NULL );
+		pNail->Spawn();
+		pNail->pev->classname = MAKE_STRING( fSuper ? "superspike" : "spike" );
+		pNail->pev->dmg = fSuper ? 18 : 9;
+		hInflictor = pNail;
+	}
+
+	return (CQuakeNail *)(CBaseEntity *)hInflictor;
 }
 
 //=========================================================
 void CQuakeNail::Spawn( void )
 {
-	Precache();
-
-	// Setup
-	pev->movetype = MOVETYPE_FLYMISSILE;
-	pev->solid = SOLID_BBOX;
-	
-	// Safety removal
-	pev->nextthink = gpGlobals->time + 6;
-	SetThink( &CQuakeNail::SUB_Remove );
-	
-	// Touch
-	SetTouch( &CQuakeNail::NailTouch );
-
-	// Model
-	SET_MODEL( ENT(pev), "models/spike.mdl" );
+	pev->movetype = MOVETYPE_NONE;
+	pev->solid = SOLID_NOT;
+
+	// don't send to clients.
+	pev->effects |= EF_NODRAW;
+
 	UTIL_SetSize(pev, Vector( 0, 0, 0), Vector(0, 0, 0));
 	UTIL_SetOrigin( pev, pev->origin );
-
-	// Damage
-	pev->dmg = 9;
 }
 
 //=========================================================
-void CQuakeNail::NailTouch( CBaseEntity *pOther )
+static void NailTouch( flyingnail_t *pNail, CBaseEntity *pOther )
 {
-	if (pOther->pev->solid == SOLID_TRIGGER)
-		return;
-
 	// Remove if we've hit skybrush
-	if ( UTIL_PointContents(pev->origin) == CONTENT_SKY )
-	{
-		UTIL_Remove( this );
+	if ( UTIL_PointContents( pNail->origin ) == CONTENT_SKY )
 		return;
-	}
 
 	// Hit something that bleeds
 	if (pOther->pev->takedamage)
 	{
-		CBaseEntity *pOwner = CBaseEntity::Instance(pev->owner);
-		
+		CBaseEntity *pOwner = pNail->hOwner;
+		CQuakeNail *pInflictor = CQuakeNail::Inflictor( pNail->fSuper );
+
+		// Damage direction and knockback are taken from where the inflictor is
+		UTIL_SetOrigin( pInflictor->pev, pNail->origin );
+
 		if ( g_pGameRules->PlayerRelationship( pOther, pOwner ) != GR_TEAMMATE )
-			SpawnBlood( pev->origin, pOther->BloodColor(), pev->dmg );
+			SpawnBlood( pNail->origin, pOther->BloodColor(), pInflictor->pev->dmg );
 
-		pOther->TakeDamage( pev, pOwner->pev, pev->dmg, DMG_GENERIC );
+		pOther->TakeDamage( pInflictor->pev, pOwner->pev, pInflictor->pev->dmg, DMG_GENERIC );
 	}
-	else
-	{
-		if ( pOther->pev->solid == SOLID_BSP || pOther->pev->movetype == MOVETYPE_PUSHSTEP )
-		{
-			TraceResult tr;
-			tr.vecEndPos = pev->origin;
-			tr.pHit = pOther->edict();
 
-			//Arent we doing this client side?
-			//UTIL_GunshotDecalTrace( &tr, DECAL_GUNSHOT1 + RANDOM_LONG( 0, 4 ) );
-		}
-	}
+	// Decals on what the nail hit are done client side
+}
+
+//=========================================================
+// Moves the nail to where it is at the end of this frame,
+// returns FALSE once it's gone.
+//=========================================================
+static BOOL MoveFlyingNail( flyingnail_t *pNail, float flEndTime )
+{
+	CBaseEntity *pOwner = pNail->hOwner;
+
+	if ( !pOwner || pNail->flRemoveTime <= flEndTime )
+		return FALSE;
 
-	UTIL_Remove( this );
+	Vector vecEnd = pNail->origin + pNail->velocity * ( flEndTime - pNail->flMoveTime );
+	pNail->flMoveTime = flEndTime;
+
+	// Nails don't hit their owner, triggers aren't hit by traces
+	TraceResult tr;
+	UTIL_TraceLine( pNail->origin, vecEnd, dont_ignore_monsters, pOwner->edict(), &tr );
+
+	pNail->origin = tr.vecEndPos;
+
+	if ( tr.flFraction == 1.0 && !tr.fStartSolid )
+		return TRUE;
+
+	NailTouch( pNail, CBaseEntity::Instance( tr.pHit ) );
+	return FALSE;
 }
 
+//=========================================================
+// Q_NailFrame - moves every flying nail, from StartFrame.
+//=========================================================
+void Q_NailFrame( void )
+{
+	// The engine moves entities to the end of the frame after StartFrame
+	float flEndTime = gpGlobals->time + gpGlobals->frametime;
+	int i = 0;
 
+	while ( i < g_iFlyingNails )
+	{
+		if ( MoveFlyingNail( &g_rgFlyingNails[i], flEndTime ) )
+			i++;
+		else
+			g_rgFlyingNails[i] = g_rgFlyingNails[--g_iFlyingNails];
+	}
+}
 
+//=========================================================
+// Q_ClearNails - the nails and their inflictors belong to
+// the previous map.
+//=========================================================
+void Q_ClearNails( void )
+{
+	g_iFlyingNails = 0;
+
+	g_hNailInflictors[0] = NULL;
+	g_hNailInflictors[1] = NULL;
+}
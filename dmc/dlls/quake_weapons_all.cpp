@@ -936,7 +936,7 @@ void CBasePlayer::W_FireSuperSpikes( int iQuadSound )
 
 	// Fire the Nail
 	Vector vecDir = GetAutoaimVector( AUTOAIM_5DEGREES );
-	CQuakeNail *pNail = CQuakeNail::CreateSuperNail( pev->origin + Vector(0,0,16), vecDir, this );
+	CQuakeNail::CreateSuperNail( pev->origin + Vector(0,0,16), vecDir, this );
 }
 
 // Nailgun
@@ -972,7 +972,7 @@ void CBasePlayer::W_FireSpikes( int iQuadSound )
 	// Fire the nail
 	UTIL_MakeVectors( pev->v_angle );
 	Vector vecDir = GetAutoaimVector( AUTOAIM_5DEGREES );
-	CQuakeNail *pNail = CQuakeNail::CreateNail( pev->origin + Vector(0,0,10) + (gpGlobals->v_right * m_iNailOffset), vecDir, this );
+	CQuakeNail::CreateNail( pev->origin + Vector(0,0,10) + (gpGlobals->v_right * m_iNailOffset), vecDir, this );
 }
 
 //===============================================================================
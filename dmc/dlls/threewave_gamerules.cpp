@@ -135,8 +135,15 @@ CThreeWave :: CThreeWave()
 	num_teams = 0;
 
 	iBlueTeamScore = iRedTeamScore = 0;
+	iBlueFlagStatus = iRedFlagStatus = 0;
 	g_bSpawnedRunes = FALSE;
 
+	memset( m_iClientTeam, 0, sizeof(m_iClientTeam) );
+	memset( m_iTeamPlayers, 0, sizeof(m_iTeamPlayers) );
+	m_iFlagCarriers = 0;
+	m_hHomeFlag[RED] = NULL;
+	m_hHomeFlag[BLUE] = NULL;
+
 	// Copy over the team from the server config
 	m_szTeamList[0] = 0;
 
@@ -167,6 +174,9 @@ CThreeWave :: CThreeWave()
 
 BOOL CThreeWave::ClientConnected( edict_t *pEntity, const char *pszName, const char *pszAddress, char szRejectReason[ 128 ] )
 {
+	// New clients start without a team
+	SetClientTeam( ENTINDEX( pEntity ), 0 );
+
 	return CHalfLifeMultiplay::ClientConnected(pEntity, pszName, pszAddress, szRejectReason);
 }
 
@@ -273,34 +283,13 @@ void CThreeWave :: JoinTeam ( CBasePlayer *pPlayer, int iTeam )
 int CThreeWave::TeamWithFewestPlayers( void )
 {
 
-	CBaseEntity *pPlayer = NULL;
-	CBasePlayer *player = NULL;
-
 	int iNumRed, iNumBlue;
 	
 	int iTeam;
 
-	// Initialize the player counts..
-	iNumRed = iNumBlue = 0;
-	
-	pPlayer = UTIL_FindEntityByClassname ( pPlayer, "player" );
-
-	while (	(pPlayer != NULL) && (!FNullEnt(pPlayer->edict()))	)
-	{
-		if (pPlayer->pev->flags != FL_DORMANT)
-		{
-			player = GetClassPtr((CBasePlayer *)pPlayer->pev);
-
-			
-				if ( player->pev->team == RED )
-					iNumRed += 1;
-	
-				else if ( player->pev->team == BLUE )
-					iNumBlue += 1;
-		
-		}
-		pPlayer = UTIL_FindEntityByClassname ( pPlayer, "player" );
-	}
+	// Player counts from the roster
+	iNumRed = m_iTeamPlayers[RED];
+	iNumBlue = m_iTeamPlayers[BLUE];
 
 	if ( iNumRed == iNumBlue )
 	{
@@ -395,6 +384,12 @@ BOOL CThreeWave :: ClientCommand( CBasePlayer *pPlayer, const char *pcmd )
 
 		return TRUE;
 	}
+	else if ( FStrEq( pcmd, "ctf_check" ) )
+	{
+		CheckTeamState();
+
+		return TRUE;
+	}
 	else if ( FStrEq( pcmd, "changeteam" ) )
 	{
 		if ( pPlayer->pev->team != 0 )
@@ -496,7 +491,7 @@ void CThreeWave :: PlayerSpawn( CBasePlayer *pPlayer )
 
 		if ( addDefault )
 		{
-			pPlayer->m_bHasFlag = FALSE;
+			SetFlagCarrier( pPlayer, FALSE );
 
 			pPlayer->m_iHideHUD &= ~HIDEHUD_WEAPONS;
 			pPlayer->m_iHideHUD &= ~HIDEHUD_FLASHLIGHT;
@@ -596,6 +591,7 @@ void CThreeWave::ChangePlayerTeam( CBasePlayer *pPlayer, int iTeam )
 
 	int oldTeam = pPlayer->pev->team;
 	pPlayer->pev->team = iTeam;
+	SetClientTeam( clientIndex, iTeam );
 
 	if ( pPlayer->pev->team == RED )
 	{
@@ -729,6 +725,7 @@ void CThreeWave :: ClientDisconnected( edict_t *pClient )
 				CItemFlag *pFlag = (CItemFlag *)pEnt; 
 				pFlag->Dropped = TRUE; 
 				pFlag->m_flDroppedTime = gpGlobals->time + TEAM_CAPTURE_FLAG_RETURN_TIME;
+				SetFlagStatus( pFlag->pev->team, RED_FLAG_DROPPED );
 
 				PLAYBACK_EVENT_FULL( FEV_GLOBAL | FEV_RELIABLE, 
 				pPlayer->edict(), g_usCarried, 0, (float *)&g_vecZero, (float *)&g_vecZero, 
@@ -745,7 +742,7 @@ void CThreeWave :: ClientDisconnected( edict_t *pClient )
 
 				m_flFlagStatusTime = gpGlobals->time + 0.1;
 
-				pPlayer->m_bHasFlag = FALSE;
+				SetFlagCarrier( pPlayer, FALSE );
 			}
 
 			// drop any runes the player has
@@ -830,6 +827,8 @@ void CThreeWave :: ClientDisconnected( edict_t *pClient )
 				GetTeamName( pPlayer->pev->team ) );
 
 			pPlayer->RemoveAllItems( TRUE );// destroy all of the players weapons and items
+
+			SetClientTeam( pPlayer->entindex(), 0 );
 		}
 	}
 }
@@ -945,10 +944,11 @@ void CThreeWave :: PlayerKilled( CBasePlayer *pVictim, entvars_t *pKiller, entva
 
 					if ( iBlueFlagStatus == BLUE_FLAG_STOLEN )
 					{
-						for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+						unsigned int iCarriers = m_iFlagCarriers;
+						CBasePlayer *pTeamMate;
+
+						while ( ( pTeamMate = NextFlagCarrier( iCarriers ) ) != NULL )
 						{
-							CBasePlayer *pTeamMate = (CBasePlayer *)UTIL_PlayerByIndex( i );
-														
 							if ( pTeamMate )
 								{
 									if ( pTeamMate->m_bHasFlag )
@@ -976,10 +976,11 @@ void CThreeWave :: PlayerKilled( CBasePlayer *pVictim, entvars_t *pKiller, entva
 
 					if ( iRedFlagStatus == RED_FLAG_STOLEN )
 					{
-						for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+						unsigned int iCarriers = m_iFlagCarriers;
+						CBasePlayer *pTeamMate;
+
+						while ( ( pTeamMate = NextFlagCarrier( iCarriers ) ) != NULL )
 						{
-							CBasePlayer *pTeamMate = (CBasePlayer *)UTIL_PlayerByIndex( i );
-														
 							if ( pTeamMate )
 								{
 									if ( pTeamMate->m_bHasFlag )
@@ -1030,6 +1031,7 @@ void CThreeWave :: PlayerKilled( CBasePlayer *pVictim, entvars_t *pKiller, entva
 		0.0, 0.0, pVictim->entindex(), pVictim->pev->team, 1, 0 );
 
 		pFlag->m_flDroppedTime = gpGlobals->time + TEAM_CAPTURE_FLAG_RETURN_TIME;
+		SetFlagStatus( pFlag->pev->team, RED_FLAG_DROPPED );
 
         MESSAGE_BEGIN ( MSG_ALL, gmsgCTFMsgs, NULL );
 			if ( pVictim->pev->team == RED )
@@ -1040,7 +1042,7 @@ void CThreeWave :: PlayerKilled( CBasePlayer *pVictim, entvars_t *pKiller, entva
 			WRITE_STRING( STRING(pVictim->pev->netname) );
 		MESSAGE_END();
 
-		pVictim->m_bHasFlag = FALSE;
+		SetFlagCarrier( pVictim, FALSE );
 
 		m_flFlagStatusTime = gpGlobals->time + 0.1;
 	}
@@ -1052,10 +1054,11 @@ void CThreeWave :: PlayerKilled( CBasePlayer *pVictim, entvars_t *pKiller, entva
 				{
 					if ( iBlueFlagStatus == BLUE_FLAG_STOLEN )
 					{
-						for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+						unsigned int iCarriers = m_iFlagCarriers;
+						CBasePlayer *pTeamMate;
+
+						while ( ( pTeamMate = NextFlagCarrier( iCarriers ) ) != NULL )
 						{
-							CBasePlayer *pTeamMate = (CBasePlayer *)UTIL_PlayerByIndex( i );
-														
 							if ( pTeamMate && pTeamMate != pk )
 								{
 									if ( pTeamMate->pev->team == pk->pev->team )
@@ -1088,10 +1091,11 @@ void CThreeWave :: PlayerKilled( CBasePlayer *pVictim, entvars_t *pKiller, entva
 				{
 					if ( iRedFlagStatus == RED_FLAG_STOLEN )
 					{
-						for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+						unsigned int iCarriers = m_iFlagCarriers;
+						CBasePlayer *pTeamMate;
+
+						while ( ( pTeamMate = NextFlagCarrier( iCarriers ) ) != NULL )
 						{
-							CBasePlayer *pTeamMate = (CBasePlayer *)UTIL_PlayerByIndex( i );
-														
 							if ( pTeamMate && pTeamMate != pk )
 								{
 									if ( pTeamMate->pev->team == pk->pev->team )
@@ -1131,12 +1135,11 @@ void CThreeWave :: PlayerKilled( CBasePlayer *pVictim, entvars_t *pKiller, entva
 	{
 		if ( pk->pev->team == RED )
 		{
-			while((ent = UTIL_FindEntityByClassname( ent, "item_flag_team1")) != NULL)
-			{
-				//Do not defend a invisible flag
-				if ( ent->pev->effects & EF_NODRAW )
-					break;
+			ent = m_hHomeFlag[RED];
 
+			//Do not defend a invisible flag
+			if ( ent && !( ent->pev->effects & EF_NODRAW ) )
+			{
 				Dist = (pk->pev->origin - ent->pev->origin).Length();
 
 				if ( Dist <= TEAM_CAPTURE_TARGET_PROTECT_RADIUS )
@@ -1147,16 +1150,16 @@ void CThreeWave :: PlayerKilled( CBasePlayer *pVictim, entvars_t *pKiller, entva
  					UTIL_ClientPrintAll( HUD_PRINTNOTIFY, " flag\n");
 
 					pk->AddPoints( TEAM_CAPTURE_FLAG_DEFENSE_BONUS, TRUE );
-					break;
 				}
 			}
 
 			if ( iBlueFlagStatus == BLUE_FLAG_STOLEN )
 				{
-					for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+					unsigned int iCarriers = m_iFlagCarriers;
+					CBasePlayer *pTeamMate;
+
+					while ( ( pTeamMate = NextFlagCarrier( iCarriers ) ) != NULL )
 					{
-						CBasePlayer *pTeamMate = (CBasePlayer *)UTIL_PlayerByIndex( i );
-														
 						if ( pTeamMate && pTeamMate != pk )
 							{
 								if ( pTeamMate->pev->team == pk->pev->team )
@@ -1183,12 +1186,11 @@ void CThreeWave :: PlayerKilled( CBasePlayer *pVictim, entvars_t *pKiller, entva
 		}
 		else if ( pk->pev->team == BLUE )
 		{
-			while((ent = UTIL_FindEntityByClassname( ent, "item_flag_team2")) != NULL)
-			{
-				//Do not defend a invisible flag
-				if ( ent->pev->effects & EF_NODRAW )
-					break;
+			ent = m_hHomeFlag[BLUE];
 
+			//Do not defend a invisible flag
+			if ( ent && !( ent->pev->effects & EF_NODRAW ) )
+			{
 				Dist = (pk->pev->origin - ent->pev->origin).Length();
 
 				if ( Dist <= TEAM_CAPTURE_TARGET_PROTECT_RADIUS )
@@ -1199,16 +1201,16 @@ void CThreeWave :: PlayerKilled( CBasePlayer *pVictim, entvars_t *pKiller, entva
  					UTIL_ClientPrintAll( HUD_PRINTNOTIFY, " flag\n");
 
 					pk->AddPoints( TEAM_CAPTURE_FLAG_DEFENSE_BONUS, TRUE );
-					break;
 				}
 			}
 
 			if ( iRedFlagStatus == RED_FLAG_STOLEN )
 				{
-					for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+					unsigned int iCarriers = m_iFlagCarriers;
+					CBasePlayer *pTeamMate;
+
+					while ( ( pTeamMate = NextFlagCarrier( iCarriers ) ) != NULL )
 					{
-						CBasePlayer *pTeamMate = (CBasePlayer *)UTIL_PlayerByIndex( i );
-													
 						if ( pTeamMate && pTeamMate != pk )
 							{
 								if ( pTeamMate->pev->team == pk->pev->team )
@@ -1442,70 +1444,6 @@ BOOL CThreeWave::IsValidTeam( const char *pTeamName )
 
 void CThreeWave::GetFlagStatus( CBasePlayer *pPlayer )
 {
-	
-	CBaseEntity *pFlag = NULL;
-    int iFoundCount = 0;
-	int iDropped = 0;
-
-	while((pFlag = UTIL_FindEntityByClassname( pFlag, "carried_flag_team1")) != NULL)
-	{
-		if ( pFlag && !FBitSet( pFlag->pev->flags, FL_KILLME) )
-			iFoundCount++;
-	}
-
-	if ( iFoundCount >= 1 )
-		iRedFlagStatus = RED_FLAG_STOLEN;
-
-	if ( !iFoundCount )
-	{
-		while((pFlag = UTIL_FindEntityByClassname( pFlag, "item_flag_team1")) != NULL)
-		{
-			if ( pFlag )
-			{
-				if ( ((CItemFlag *)pFlag)->Dropped )
-					iDropped++;
-
-				iFoundCount++;
-			}
-		}
-			
-		if ( iFoundCount > 1 && iDropped == 1 )
-			iRedFlagStatus = RED_FLAG_DROPPED;
-		else if ( iFoundCount >= 1 && iDropped == 0 )
-			iRedFlagStatus = RED_FLAG_ATBASE;
-	}
-
-	iDropped = iFoundCount = 0;
-
-	while((pFlag = UTIL_FindEntityByClassname( pFlag, "carried_flag_team2")) != NULL)
-	{
-		if ( pFlag && !FBitSet( pFlag->pev->flags, FL_KILLME) )
-			iFoundCount++;
-	}
-
-	if ( iFoundCount >= 1 )
-		iBlueFlagStatus = BLUE_FLAG_STOLEN;
-
-	if ( !iFoundCount )
-	{
-
-		while((pFlag = UTIL_FindEntityByClassname( pFlag, "item_flag_team2")) != NULL)
-		{
-			if ( pFlag )
-			{
-				if ( ((CItemFlag *)pFlag)->Dropped )
-					iDropped++;
-
-				iFoundCount++;
-			}
-		}
-			
-		if ( iFoundCount > 1 && iDropped == 1 )
-			iBlueFlagStatus = BLUE_FLAG_DROPPED;
-		else if ( iFoundCount >= 1 && iDropped == 0 )
-			iBlueFlagStatus = BLUE_FLAG_ATBASE;
-	}
-
 	if ( pPlayer )
 	{
 		if ( pPlayer->pev->team == 0 )
@@ -1633,6 +1571,173 @@ void CThreeWave::RecountTeams( void )
 	}
 }
 
+//=========================================================
+// Team roster and flag state
+//=========================================================
+void CThreeWave::SetClientTeam( int clientIndex, int iTeam )
+{
+	if ( clientIndex < 1 || clientIndex > 32 )
+		return;
+
+	if ( iTeam < 0 || iTeam > BLUE )
+		iTeam = 0;
+
+	m_iTeamPlayers[m_iClientTeam[clientIndex]]--;
+	m_iTeamPlayers[iTeam]++;
+	m_iClientTeam[clientIndex] = iTeam;
+
+	// Leaving the game
+	if ( iTeam == 0 )
+		m_iFlagCarriers &= ~( 1 << ( clientIndex - 1 ) );
+}
+
+void CThreeWave::SetFlagCarrier( CBasePlayer *pPlayer, BOOL fHasFlag )
+{
+	int clientIndex = pPlayer->entindex();
+
+	pPlayer->m_bHasFlag = fHasFlag;
+
+	if ( fHasFlag )
+		m_iFlagCarriers |= 1 << ( clientIndex - 1 );
+	else
+		m_iFlagCarriers &= ~( 1 << ( clientIndex - 1 ) );
+}
+
+CBasePlayer *CThreeWave::NextFlagCarrier( unsigned int &iCarriers )
+{
+	while ( iCarriers )
+	{
+		int clientIndex = 1;
+		while ( !( iCarriers & ( 1 << ( clientIndex - 1 ) ) ) )
+			clientIndex++;
+
+		iCarriers &= ~( 1 << ( clientIndex - 1 ) );
+
+		CBasePlayer *pPlayer = (CBasePlayer *)UTIL_PlayerByIndex( clientIndex );
+		if ( pPlayer )
+			return pPlayer;
+	}
+
+	return NULL;
+}
+
+// iRedStatus is one of the RED_FLAG_ values, the BLUE_FLAG_ one is always one more
+void CThreeWave::SetFlagStatus( int iFlagTeam, int iRedStatus )
+{
+	if ( iFlagTeam == RED )
+		iRedFlagStatus = iRedStatus;
+	else if ( iFlagTeam == BLUE )
+		iBlueFlagStatus = iRedStatus + 1;
+}
+
+void CThreeWave::SetHomeFlag( CItemFlag *pFlag )
+{
+	if ( pFlag->pev->team != RED && pFlag->pev->team != BLUE )
+		return;
+
+	if ( m_hHomeFlag[pFlag->pev->team] == NULL )
+		m_hHomeFlag[pFlag->pev->team] = pFlag;
+
+	SetFlagStatus( pFlag->pev->team, RED_FLAG_ATBASE );
+}
+
+// Flag status worked out from the flag entities, 0 if they don't tell
+static int FindFlagStatus( int iTeam )
+{
+	CBaseEntity *pFlag = NULL;
+	int iFoundCount = 0;
+	int iDropped = 0;
+	int iStatus = 0;
+
+	while((pFlag = UTIL_FindEntityByClassname( pFlag, iTeam == RED ? "carried_flag_team1" : "carried_flag_team2" )) != NULL)
+	{
+		if ( !FBitSet( pFlag->pev->flags, FL_KILLME) )
+			iFoundCount++;
+	}
+
+	if ( iFoundCount >= 1 )
+		return iTeam == RED ? RED_FLAG_STOLEN : BLUE_FLAG_STOLEN;
+
+	while((pFlag = UTIL_FindEntityByClassname( pFlag, iTeam == RED ? "item_flag_team1" : "item_flag_team2" )) != NULL)
+	{
+		if ( ((CItemFlag *)pFlag)->Dropped )
+			iDropped++;
+
+		iFoundCount++;
+	}
+
+	if ( iFoundCount > 1 && iDropped == 1 )
+		iStatus = RED_FLAG_DROPPED;
+	else if ( iFoundCount >= 1 && iDropped == 0 )
+		iStatus = RED_FLAG_ATBASE;
+	else
+		return 0;
+
+	return iTeam == RED ? iStatus : iStatus + 1;
+}
+
+//=========================================================
+// CheckTeamState - compares the roster and flag state with
+// the players and flag entities, for "ctf_check". A lost
+// carried flag is only removed on its next think, so right
+// after a drop the flag entities still say stolen.
+//=========================================================
+void CThreeWave::CheckTeamState( void )
+{
+	int iTeamPlayers[BLUE + 1];
+	int iErrors = 0;
+
+	memset( iTeamPlayers, 0, sizeof(iTeamPlayers) );
+
+	for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+	{
+		CBasePlayer *pPlayer = (CBasePlayer *)UTIL_PlayerByIndex( i );
+		int iTeam = 0;
+		BOOL fHasFlag = FALSE;
+
+		if ( pPlayer )
+		{
+			iTeam = pPlayer->pev->team;
+			fHasFlag = pPlayer->m_bHasFlag;
+		}
+
+		if ( iTeam >= 0 && iTeam <= BLUE )
+			iTeamPlayers[iTeam]++;
+
+		if ( m_iClientTeam[i] != iTeam )
+		{
+			ALERT( at_console, "CTF: client %d is on team %d, roster has %d\n", i, iTeam, m_iClientTeam[i] );
+			iErrors++;
+		}
+
+		if ( ( ( m_iFlagCarriers >> ( i - 1 ) ) & 1 ) != ( fHasFlag ? 1 : 0 ) )
+		{
+			ALERT( at_console, "CTF: client %d %s the flag, roster disagrees\n", i, fHasFlag ? "has" : "doesn't have" );
+			iErrors++;
+		}
+	}
+
+	for ( int iTeam = RED; iTeam <= BLUE; iTeam++ )
+	{
+		if ( m_iTeamPlayers[iTeam] != iTeamPlayers[iTeam] )
+		{
+			ALERT( at_console, "CTF: %s has %d players, roster counts %d\n", GetTeamName( iTeam ), iTeamPlayers[iTeam], m_iTeamPlayers[iTeam] );
+			iErrors++;
+		}
+
+		int iStatus = FindFlagStatus( iTeam );
+		int iKept = iTeam == RED ? iRedFlagStatus : iBlueFlagStatus;
+
+		if ( iStatus && iStatus != iKept )
+		{
+			ALERT( at_console, "CTF: %s flag status is %d, flags say %d\n", GetTeamName( iTeam ), iKept, iStatus );
+			iErrors++;
+		}
+	}
+
+	ALERT( at_console, "CTF: team and flag state checked, %d errors\n", iErrors );
+}
+
 /*****************************************************
 ******************************************************
                 THREEWAVE CTF FLAG CODE
@@ -1649,6 +1754,19 @@ enum Flag_Anims
 }; 
 
 
+//=========================================================
+// ThreeWaveRules - the installed rules if they are
+// Threewave CTF, otherwise NULL. Flags can be placed in any
+// map, but only CThreeWave keeps their state.
+//=========================================================
+static CThreeWave *ThreeWaveRules( void )
+{
+	if ( g_pGameRules && g_pGameRules->IsCTF() )
+		return (CThreeWave *)g_pGameRules;
+
+	return NULL;
+}
+
 void CItemFlag::Spawn ( void )
 {
     Precache( );
@@ -1672,6 +1790,10 @@ void CItemFlag::Spawn ( void )
 
     pev->sequence = NOT_CARRIED;
     pev->framerate = 1.0; 
+
+	// Placed in the map, dropped flags have an owner
+	if ( FNullEnt( pev->owner ) && ThreeWaveRules() )
+		ThreeWaveRules()->SetHomeFlag( this );
    
    // if ( !DROP_TO_FLOOR(ENT(pev)) )
    //       ResetFlag( pev->team );
@@ -1679,6 +1801,11 @@ void CItemFlag::Spawn ( void )
 
 void CItemFlag::FlagTouch ( CBaseEntity *pToucher  )
 {
+	CThreeWave *pRules = ThreeWaveRules();
+
+	if ( !pRules )
+		return;
+
 	if ( !pToucher )
 		return;
 
@@ -1715,12 +1842,13 @@ void CItemFlag::FlagTouch ( CBaseEntity *pToucher  )
 					GETPLAYERAUTHID( pPlayer->edict() ),
 					GetTeamName( pPlayer->pev->team ) );
 
-				if ( ((CThreeWave *) g_pGameRules)->iBlueFlagStatus == BLUE_FLAG_STOLEN )
+				if ( pRules->iBlueFlagStatus == BLUE_FLAG_STOLEN )
 				{
-					for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+					unsigned int iCarriers = pRules->m_iFlagCarriers;
+					CBasePlayer *pTeamMate;
+
+					while ( ( pTeamMate = pRules->NextFlagCarrier( iCarriers ) ) != NULL )
 					{
-						CBasePlayer *pTeamMate = (CBasePlayer *)UTIL_PlayerByIndex( i );
-													
 						if ( pTeamMate )
 						{
 							if ( pTeamMate->m_bHasFlag )
@@ -1741,12 +1869,13 @@ void CItemFlag::FlagTouch ( CBaseEntity *pToucher  )
 					GETPLAYERAUTHID( pPlayer->edict() ),
 					GetTeamName( pPlayer->pev->team ) );
 
-				if ( ((CThreeWave *) g_pGameRules)->iRedFlagStatus == RED_FLAG_STOLEN )
+				if ( pRules->iRedFlagStatus == RED_FLAG_STOLEN )
 				{
-					for ( int i = 1; i <= gpGlobals->maxClients; i++ )
+					unsigned int iCarriers = pRules->m_iFlagCarriers;
+					CBasePlayer *pTeamMate;
+
+					while ( ( pTeamMate = pRules->NextFlagCarrier( iCarriers ) ) != NULL )
 					{
-						CBasePlayer *pTeamMate = (CBasePlayer *)UTIL_PlayerByIndex( i );
-													
 						if ( pTeamMate )
 						{
 							if ( pTeamMate->m_bHasFlag )
@@ -1813,7 +1942,7 @@ void CItemFlag::FlagTouch ( CBaseEntity *pToucher  )
 
 			MESSAGE_END();
 
-			pPlayer->m_bHasFlag = TRUE;
+			pRules->SetFlagCarrier( pPlayer, TRUE );
 
 			CBaseEntity *pEnt = NULL;
 
@@ -1864,7 +1993,7 @@ void CItemFlag::FlagTouch ( CBaseEntity *pToucher  )
 
 			MESSAGE_END();
 
-			pPlayer->m_bHasFlag = TRUE;
+			pRules->SetFlagCarrier( pPlayer, TRUE );
 			pPlayer->m_flCarrierPickupTime = gpGlobals->time + TEAM_CAPTURE_CARRIER_FLAG_SINCE_TIMEOUT;
 
 			CBaseEntity *pEnt = NULL;
@@ -1898,13 +2027,18 @@ void CItemFlag::FlagTouch ( CBaseEntity *pToucher  )
 			0.0, 0.0, pPlayer->entindex(), pPlayer->pev->team, 0, 0 );
 		}
 		
-		((CThreeWave *) g_pGameRules)->m_flFlagStatusTime = gpGlobals->time + 0.1;
+		pRules->SetFlagStatus( pev->team, RED_FLAG_STOLEN );
+		pRules->m_flFlagStatusTime = gpGlobals->time + 0.1;
 	}
 }
 
 void CItemFlag::Capture(CBasePlayer *pPlayer, int iTeam )
 {
 	CBaseEntity *pFlag1 = NULL; 
+	CThreeWave *pRules = ThreeWaveRules();
+
+	if ( !pRules )
+		return;
 
 	MESSAGE_BEGIN ( MSG_ALL, gmsgCTFMsgs, NULL );
 	
@@ -1965,7 +2099,7 @@ void CItemFlag::Capture(CBasePlayer *pPlayer, int iTeam )
 
 	if ( iTeam == RED )
 	{
-		((CThreeWave *) g_pGameRules)->iBlueTeamScore++;
+		pRules->iBlueTeamScore++;
 
 		while((pFlag1 = UTIL_FindEntityByClassname( pFlag1, "carried_flag_team1")) != NULL)
 		{
@@ -1975,7 +2109,7 @@ void CItemFlag::Capture(CBasePlayer *pPlayer, int iTeam )
 	}
 	else if ( iTeam == BLUE )
 	{
-		((CThreeWave *) g_pGameRules)->iRedTeamScore++;
+		pRules->iRedTeamScore++;
 
 		while((pFlag1 = UTIL_FindEntityByClassname( pFlag1, "carried_flag_team2")) != NULL)
 		{
@@ -1984,7 +2118,7 @@ void CItemFlag::Capture(CBasePlayer *pPlayer, int iTeam )
 		}
 	}
 
-	pPlayer->m_bHasFlag = FALSE;
+	pRules->SetFlagCarrier( pPlayer, FALSE );
 
 	pPlayer->AddPoints( TEAM_CAPTURE_CAPTURE_BONUS, TRUE );
 
@@ -2053,7 +2187,11 @@ void CItemFlag::ResetFlag( int iTeam )
 		}
 	}
 
-	((CThreeWave *) g_pGameRules)->m_flFlagStatusTime = gpGlobals->time + 0.1;
+	if ( ThreeWaveRules() )
+	{
+		ThreeWaveRules()->SetFlagStatus( iTeam, RED_FLAG_ATBASE );
+		ThreeWaveRules()->m_flFlagStatusTime = gpGlobals->time + 0.1;
+	}
 
 } 
 
@@ -174,6 +174,7 @@ public:
 	virtual BOOL ClientCommand( CBasePlayer *pPlayer, const char *pcmd );
 	virtual void ClientUserInfoChanged( CBasePlayer *pPlayer, char *infobuffer );
 	virtual BOOL IsTeamplay( void );
+	virtual BOOL IsCTF( void ) { return TRUE; }
 	virtual BOOL FPlayerCanTakeDamage( CBasePlayer *pPlayer, CBaseEntity *pAttacker );
 	virtual int PlayerRelationship( CBaseEntity *pPlayer, CBaseEntity *pTarget );
 	virtual const char *GetTeamID( CBaseEntity *pEntity );
@@ -201,6 +202,17 @@ public:
 
 	void PlayerTakeDamage( CBasePlayer *pPlayer , CBaseEntity *pAttacker );
 
+	// Flag state, kept as flags are stolen, dropped and returned
+	// instead of looked for among the entities
+	void SetFlagStatus( int iFlagTeam, int iRedStatus );
+	void SetFlagCarrier( CBasePlayer *pPlayer, BOOL fHasFlag );
+	void SetHomeFlag( CItemFlag *pFlag );
+	void CheckTeamState( void );
+
+	// Pops the next flag carrier off iCarriers, a copy of m_iFlagCarriers
+	CBasePlayer *NextFlagCarrier( unsigned int &iCarriers );
+	unsigned int m_iFlagCarriers;	// bit clientIndex - 1 for each flag carrier
+
 	int iBlueFlagStatus;
 	int iRedFlagStatus;
 
@@ -212,6 +224,13 @@ public:
 private:
 	void RecountTeams( void );
 
+	void SetClientTeam( int clientIndex, int iTeam );
+
+	// Team roster, by client index
+	int m_iClientTeam[32 + 1];
+	int m_iTeamPlayers[BLUE + 1];
+	EHANDLE m_hHomeFlag[BLUE + 1];
+
 	BOOL m_DisableDeathMessages;
 	BOOL m_DisableDeathPenalty;
 	BOOL m_teamLimit;				// This means the server set only some teams as valid
@@ -477,15 +477,20 @@ public:
 	float	m_flAttackFinished;
 };
 
+// Flying nails aren't entities, see quake_nail.cpp. A CQuakeNail is what
+// deals the damage when one hits, there's one for each kind of nail.
 class CQuakeNail : public CBaseEntity
 {
 public:
 	void Spawn( void );
-	static  CQuakeNail *CreateNail( Vector vecOrigin, Vector vecAngles, CBaseEntity *pOwner );
-	static  CQuakeNail *CreateSuperNail( Vector vecOrigin, Vector vecAngles, CBaseEntity *pOwner );
-	void	EXPORT NailTouch( CBaseEntity *pOther );
+	static  void CreateNail( Vector vecOrigin, Vector vecAngles, CBaseEntity *pOwner );
+	static  void CreateSuperNail( Vector vecOrigin, Vector vecAngles, CBaseEntity *pOwner );
+	static  CQuakeNail *Inflictor( BOOL fSuper );
 };
 
+void Q_NailFrame( void );
+void Q_ClearNails( void );
+
 extern char gszQ_DeathType[128];
 extern DLL_GLOBAL	short	g_sModelIndexNail;
 
@@ -478,6 +478,7 @@ void CWorld :: Spawn( void )
 void CWorld :: Precache( void )
 {
 	g_pLastSpawn = NULL;
+	Q_ClearNails();
 
 #if 1
 	CVAR_SET_STRING("sv_gravity", "800"); // 67ft/sec
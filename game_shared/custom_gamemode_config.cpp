@@ -829,9 +829,9 @@ bool CustomGameModeConfig::ReadFile( const char *fileName ) {
 	sha1 = GetHash();
 
 	const std::string recordDirectoryPath = GetGamePath() + "\\records\\";
-	const std::string recordFileName = CustomGameModeConfig::ConfigTypeToGameModeCommand( configType ) + "_" + configNameSeparated.back() +  + "_" + sha1 + ".hpr";
+	const std::string recordName = CustomGameModeConfig::ConfigTypeToGameModeCommand( configType ) + "_" + configNameSeparated.back() + "_" + sha1;
 	
-	gameFinishedOnce = record.Read( recordDirectoryPath, recordFileName );
+	gameFinishedOnce = record.Read( recordDirectoryPath, recordName );
 
 	inp.close();
 
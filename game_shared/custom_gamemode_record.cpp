@@ -1,72 +1,68 @@
 #include "custom_gamemode_record.h"
 #include "gameplay_mod.h"
-#include <fstream>
 
-const int MAGIC_NUMBER_HEADER = 1;
-
-bool CustomGameModeRecord::Read( const std::string &directoryPath, const std::string &fileName ) {
+bool CustomGameModeRecord::Read( const std::string &directoryPath, const std::string &recordName ) {
 
 	this->directoryPath = directoryPath;
-	this->filePath = directoryPath + fileName;
+	this->recordName = recordName;
 
-	std::ifstream inp( filePath, std::ios::in | std::ios::binary );
-	if ( inp.is_open() ) {
+	auto &store = CustomGameModeRecordStore::Get();
+	store.Load( directoryPath );
 
-		int magicNumber;
-		inp.read( ( char * ) &magicNumber, sizeof( int ) );
-		if ( magicNumber != MAGIC_NUMBER_HEADER ) {
+	CustomGameModeRecordData data;
+	if ( !store.Find( recordName, data ) ) {
+		// Records made before the records database existed are kept as separate .hpr files
+		if ( !store.Import( recordName, directoryPath + recordName + ".hpr", data ) ) {
 			return false;
 		}
+	}
 
-		inp.read( ( char * ) &time, sizeof( float ) );
-		inp.read( ( char * ) &realTime, sizeof( float ) );
-		inp.read( ( char * ) &realTimeMinusTime, sizeof( float ) );
-		inp.read( ( char * ) &score, sizeof( int ) );
+	time = data.time;
+	realTime = data.realTime;
+	realTimeMinusTime = data.realTimeMinusTime;
+	score = data.score;
 
-		inp.read( ( char * ) &secondsInSlowmotion, sizeof( float ) );
-		inp.read( ( char * ) &kills, sizeof( int ) );
-		inp.read( ( char * ) &headshotKills, sizeof( int ) );
-		inp.read( ( char * ) &explosiveKills, sizeof( int ) );
-		inp.read( ( char * ) &crowbarKills, sizeof( int ) );
-		inp.read( ( char * ) &projectileKills, sizeof( int ) );
+	secondsInSlowmotion = data.secondsInSlowmotion;
+	kills = data.kills;
+	headshotKills = data.headshotKills;
+	explosiveKills = data.explosiveKills;
+	crowbarKills = data.crowbarKills;
+	projectileKills = data.projectileKills;
 
-		return true;
-	} else {
-		return false;
-	}
+	splits = data.splits;
+
+	return true;
 }
 
 void CustomGameModeRecord::Save( CBasePlayer *player ) {
 
-	// Create the directory if it's not there. Proceed only when directory exists
-	if ( CreateDirectory( directoryPath.c_str(), NULL ) || GetLastError() == ERROR_ALREADY_EXISTS ) {
-
-		float time = gameplayMods::timeRestriction.isActive() ?
-			( gameplayModsData.time > this->time ? gameplayModsData.time : this->time ) :
-			( gameplayModsData.time < this->time ? gameplayModsData.time : this->time );
-		float realTime = gameplayModsData.realTime < this->realTime ? gameplayModsData.realTime : this->realTime;
-		float realTimeMinusTime = max( 0.0f, realTime - time );
-		if ( realTimeMinusTime > this->realTimeMinusTime ) {
-			realTimeMinusTime = this->realTimeMinusTime;
-		}
-
-		int score = gameplayModsData.score > this->score ? gameplayModsData.score : this->score;
+	bool timeBeaten = gameplayMods::timeRestriction.isActive() ?
+		gameplayModsData.time > this->time :
+		gameplayModsData.time < this->time;
 
-		std::ofstream out( filePath, std::ios::out | std::ios::binary );
+	CustomGameModeRecordData data;
+	data.time = timeBeaten ? gameplayModsData.time : this->time;
+	data.realTime = gameplayModsData.realTime < this->realTime ? gameplayModsData.realTime : this->realTime;
+	data.realTimeMinusTime = max( 0.0f, data.realTime - data.time );
+	if ( data.realTimeMinusTime > this->realTimeMinusTime ) {
+		data.realTimeMinusTime = this->realTimeMinusTime;
+	}
 
-		out.write( ( char * ) &MAGIC_NUMBER_HEADER, sizeof( int ) );
-		out.write( ( char * ) &time, sizeof( float ) );
-		out.write( ( char * ) &realTime, sizeof( float ) );
-		out.write( ( char * ) &realTimeMinusTime, sizeof( float ) );
-		out.write( ( char * ) &score, sizeof( int ) );
+	data.score = gameplayModsData.score > this->score ? gameplayModsData.score : this->score;
 
-		out.write( ( char * ) &gameplayModsData.secondsInSlowmotion, sizeof( float ) );
-		out.write( ( char * ) &gameplayModsData.kills, sizeof( int ) );
-		out.write( ( char * ) &gameplayModsData.headshotKills, sizeof( int ) );
-		out.write( ( char * ) &gameplayModsData.explosiveKills, sizeof( int ) );
-		out.write( ( char * ) &gameplayModsData.crowbarKills, sizeof( int ) );
-		out.write( ( char * ) &gameplayModsData.projectileKills, sizeof( int ) );
+	data.secondsInSlowmotion = gameplayModsData.secondsInSlowmotion;
+	data.kills = gameplayModsData.kills;
+	data.headshotKills = gameplayModsData.headshotKills;
+	data.explosiveKills = gameplayModsData.explosiveKills;
+	data.crowbarKills = gameplayModsData.crowbarKills;
+	data.projectileKills = gameplayModsData.projectileKills;
 
-		out.close();
+	// Splits belong to the run that set the best time
+	if ( timeBeaten ) {
+		data.splits.assign( gameplayModsData.splits, gameplayModsData.splits + gameplayModsData.splitsCount );
+	} else {
+		data.splits = splits;
 	}
-}
\ No newline at end of file
+
+	CustomGameModeRecordStore::Get().Append( recordName, data );
+}
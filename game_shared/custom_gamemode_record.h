@@ -5,6 +5,7 @@
 #include "util.h"
 #include "cbase.h"
 #include "player.h"
+#include "custom_gamemode_record_store.h"
 
 const float DEFAULT_TIME = 59999.0f; // 999:59.00
 
@@ -12,9 +13,9 @@ class CustomGameModeRecord {
 public:
 
 	std::string directoryPath;
-	std::string filePath;
+	std::string recordName;
 
-	bool Read( const std::string &directoryPath, const std::string &fileName );
+	bool Read( const std::string &directoryPath, const std::string &recordName );
 	void Save( CBasePlayer *player );
 
 	float time = DEFAULT_TIME;
@@ -29,6 +30,8 @@ public:
 	int crowbarKills = 0;
 	int projectileKills = 0;
 
+	std::vector<float> splits;
+
 };
 
 #endif // CUSTOM_GAMEMODE_RECORD_H
\ No newline at end of file
@@ -0,0 +1,348 @@
+#include "custom_gamemode_record_store.h"
+#include "simple_checksum.h"
+#include <cstring>
+#include <fstream>
+#include <Windows.h>
+
+const char RECORDS_FILE_NAME[] = "records.hpdb";
+
+const uint32_t RECORDS_FILE_MAGIC = 'BDPH';
+const uint32_t RECORDS_FILE_VERSION = 1;
+const uint32_t RECORD_ENTRY_MAGIC = 'ERPH';
+
+const int LEGACY_MAGIC_NUMBER_HEADER = 1;
+const uint32_t LEGACY_PAYLOAD_SIZE = 10 * 4;
+
+#pragma pack( push, 1 )
+struct RecordsFileHeader {
+	uint32_t magic;
+	uint32_t version;
+};
+
+struct RecordEntryHeader {
+	uint32_t magic;
+	uint16_t schema;
+	uint16_t keyLength;
+	uint32_t payloadLength;
+
+	// ComputeSimpleChecksum of key and payload which follow the header
+	uint32_t checksum;
+};
+#pragma pack( pop )
+
+CustomGameModeRecordStore &CustomGameModeRecordStore::Get() {
+	// Never destroyed, so there is no static destructor to race the writer thread or join it under the loader lock
+	static CustomGameModeRecordStore *store = new CustomGameModeRecordStore();
+	return *store;
+}
+
+void CustomGameModeRecordStore::Shutdown() {
+	{
+		std::lock_guard<std::mutex> guard( writerMutex );
+		writerStop = true;
+	}
+	writerWakeUp.notify_all();
+
+	if ( writerThread.joinable() ) {
+		writerThread.join();
+	}
+
+	writerStop = false;
+}
+
+void CustomGameModeRecordStore::Load( const std::string &directoryPath ) {
+	if ( loaded && this->directoryPath == directoryPath ) {
+		return;
+	}
+
+	// Queued entries belong to the old file
+	Shutdown();
+
+	this->directoryPath = directoryPath;
+	this->filePath = directoryPath + RECORDS_FILE_NAME;
+	index.clear();
+	checkedLegacyKeys.clear();
+	scannedUntil = 0;
+	incompatible = false;
+	loaded = true;
+
+	Scan();
+}
+
+void CustomGameModeRecordStore::Refresh() {
+	if ( loaded ) {
+		Scan();
+	}
+}
+
+bool CustomGameModeRecordStore::Find( const std::string &key, CustomGameModeRecordData &data ) {
+	auto record = index.find( key );
+	if ( record == index.end() ) {
+		return false;
+	}
+
+	data = record->second;
+	return true;
+}
+
+void CustomGameModeRecordStore::Scan() {
+	if ( incompatible ) {
+		return;
+	}
+
+	HANDLE file = CreateFile( filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		return;
+	}
+
+	LARGE_INTEGER fileSize;
+	if ( !GetFileSizeEx( file, &fileSize ) || ( uint64_t ) fileSize.QuadPart <= scannedUntil || ( uint64_t ) fileSize.QuadPart < sizeof( RecordsFileHeader ) ) {
+		CloseHandle( file );
+		return;
+	}
+
+	HANDLE mapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	const unsigned char *view = mapping ? ( const unsigned char * ) MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) : NULL;
+	if ( !view ) {
+		if ( mapping ) {
+			CloseHandle( mapping );
+		}
+		CloseHandle( file );
+		return;
+	}
+
+	const uint64_t size = fileSize.QuadPart;
+	uint64_t offset = scannedUntil;
+
+	if ( offset == 0 ) {
+		RecordsFileHeader fileHeader;
+		memcpy( &fileHeader, view, sizeof( RecordsFileHeader ) );
+		if ( fileHeader.magic == RECORDS_FILE_MAGIC && fileHeader.version <= RECORDS_FILE_VERSION ) {
+			offset = sizeof( RecordsFileHeader );
+			scannedUntil = offset;
+		} else {
+			incompatible = true;
+		}
+	}
+
+	while ( !incompatible && offset + sizeof( RecordEntryHeader ) <= size ) {
+		RecordEntryHeader header;
+		memcpy( &header, view + offset, sizeof( RecordEntryHeader ) );
+
+		const uint64_t dataLength = ( uint64_t ) header.keyLength + header.payloadLength;
+		const unsigned char *key = view + offset + sizeof( RecordEntryHeader );
+
+		// Resynchronize byte by byte when the entry is damaged, so a torn write doesn't hide later entries
+		if (
+			header.magic != RECORD_ENTRY_MAGIC ||
+			offset + sizeof( RecordEntryHeader ) + dataLength > size ||
+			ComputeSimpleChecksum( key, ( int ) dataLength ) != header.checksum
+		) {
+			offset++;
+			continue;
+		}
+
+		CustomGameModeRecordData data;
+		if ( Deserialize( header.schema, key + header.keyLength, header.payloadLength, data ) ) {
+			index[std::string( ( const char * ) key, header.keyLength )] = data;
+		}
+
+		offset += sizeof( RecordEntryHeader ) + dataLength;
+		scannedUntil = offset;
+	}
+
+	UnmapViewOfFile( view );
+	CloseHandle( mapping );
+	CloseHandle( file );
+}
+
+bool CustomGameModeRecordStore::Import( const std::string &key, const std::string &legacyFilePath, CustomGameModeRecordData &data ) {
+	// Legacy files are read at most once, an imported key is found in the index after that
+	if ( !checkedLegacyKeys.insert( key ).second ) {
+		return false;
+	}
+
+	std::ifstream inp( legacyFilePath, std::ios::in | std::ios::binary );
+	if ( !inp.is_open() ) {
+		return false;
+	}
+
+	int magicNumber;
+	if ( !inp.read( ( char * ) &magicNumber, sizeof( int ) ) || magicNumber != LEGACY_MAGIC_NUMBER_HEADER ) {
+		return false;
+	}
+
+	std::vector<unsigned char> payload( LEGACY_PAYLOAD_SIZE );
+	if ( !inp.read( ( char * ) payload.data(), payload.size() ) ) {
+		return false;
+	}
+
+	if ( !Deserialize( RECORD_SCHEMA_HPR, payload.data(), payload.size(), data ) ) {
+		return false;
+	}
+
+	index[key] = data;
+	AppendRaw( key, RECORD_SCHEMA_HPR, payload );
+
+	return true;
+}
+
+void CustomGameModeRecordStore::Append( const std::string &key, const CustomGameModeRecordData &data ) {
+	index[key] = data;
+	AppendRaw( key, RECORD_SCHEMA_CURRENT, Serialize( data ) );
+}
+
+void CustomGameModeRecordStore::AppendRaw( const std::string &key, uint16_t schema, const std::vector<unsigned char> &payload ) {
+	// Records still work for this session, but the file is left as it is
+	if ( incompatible ) {
+		return;
+	}
+
+	std::vector<unsigned char> entry( sizeof( RecordEntryHeader ) );
+	entry.insert( entry.end(), key.begin(), key.end() );
+	entry.insert( entry.end(), payload.begin(), payload.end() );
+
+	RecordEntryHeader header;
+	header.magic = RECORD_ENTRY_MAGIC;
+	header.schema = schema;
+	header.keyLength = ( uint16_t ) key.size();
+	header.payloadLength = ( uint32_t ) payload.size();
+	header.checksum = ComputeSimpleChecksum( entry.data() + sizeof( RecordEntryHeader ), ( int ) ( key.size() + payload.size() ) );
+	memcpy( entry.data(), &header, sizeof( RecordEntryHeader ) );
+
+	{
+		std::lock_guard<std::mutex> guard( writerMutex );
+		pendingEntries.push_back( std::move( entry ) );
+
+		if ( !writerThread.joinable() ) {
+			writerDirectoryPath = directoryPath;
+			writerFilePath = filePath;
+			writerThread = std::thread( &CustomGameModeRecordStore::WriterThread, this );
+		}
+	}
+	writerWakeUp.notify_one();
+}
+
+void CustomGameModeRecordStore::WriterThread() {
+	std::unique_lock<std::mutex> lock( writerMutex );
+
+	while ( true ) {
+		writerWakeUp.wait( lock, [this] { return writerStop || !pendingEntries.empty(); } );
+
+		if ( pendingEntries.empty() ) {
+			break;
+		}
+
+		std::deque<std::vector<unsigned char>> entries;
+		entries.swap( pendingEntries );
+
+		// Saves that come in while the disk is busy are queued and written in the next pass
+		lock.unlock();
+		WriteEntries( entries );
+		lock.lock();
+	}
+}
+
+void CustomGameModeRecordStore::WriteEntries( const std::deque<std::vector<unsigned char>> &entries ) {
+	// Create the directory if it's not there. Proceed only when directory exists
+	if ( !CreateDirectory( writerDirectoryPath.c_str(), NULL ) && GetLastError() != ERROR_ALREADY_EXISTS ) {
+		return;
+	}
+
+	HANDLE file = CreateFile( writerFilePath.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		return;
+	}
+
+	DWORD written = 0;
+
+	LARGE_INTEGER fileSize;
+	if ( GetFileSizeEx( file, &fileSize ) && fileSize.QuadPart == 0 ) {
+		RecordsFileHeader fileHeader = { RECORDS_FILE_MAGIC, RECORDS_FILE_VERSION };
+		WriteFile( file, &fileHeader, sizeof( RecordsFileHeader ), &written, NULL );
+	}
+
+	// Each entry is written in one call, so it either lands whole or fails its checksum after a crash
+	for ( const auto &entry : entries ) {
+		WriteFile( file, entry.data(), ( DWORD ) entry.size(), &written, NULL );
+	}
+
+	FlushFileBuffers( file );
+	CloseHandle( file );
+}
+
+template<typename T>
+static void WriteValue( std::vector<unsigned char> &buffer, const T &value ) {
+	buffer.insert( buffer.end(), ( const unsigned char * ) &value, ( const unsigned char * ) &value + sizeof( T ) );
+}
+
+template<typename T>
+static bool ReadValue( const unsigned char *&cursor, const unsigned char *end, T &value ) {
+	if ( cursor + sizeof( T ) > end ) {
+		return false;
+	}
+
+	memcpy( &value, cursor, sizeof( T ) );
+	cursor += sizeof( T );
+	return true;
+}
+
+std::vector<unsigned char> CustomGameModeRecordStore::Serialize( const CustomGameModeRecordData &data ) {
+	std::vector<unsigned char> buffer;
+
+	WriteValue( buffer, data.time );
+	WriteValue( buffer, data.realTime );
+	WriteValue( buffer, data.realTimeMinusTime );
+	WriteValue( buffer, data.score );
+
+	WriteValue( buffer, data.secondsInSlowmotion );
+	WriteValue( buffer, data.kills );
+	WriteValue( buffer, data.headshotKills );
+	WriteValue( buffer, data.explosiveKills );
+	WriteValue( buffer, data.crowbarKills );
+	WriteValue( buffer, data.projectileKills );
+
+	uint32_t splitsCount = ( uint32_t ) min( data.splits.size(), ( size_t ) RECORD_MAX_SPLITS );
+	WriteValue( buffer, splitsCount );
+	for ( uint32_t i = 0; i < splitsCount; i++ ) {
+		WriteValue( buffer, data.splits[i] );
+	}
+
+	return buffer;
+}
+
+bool CustomGameModeRecordStore::Deserialize( uint16_t schema, const unsigned char *payload, uint32_t payloadLength, CustomGameModeRecordData &data ) {
+	if ( schema < RECORD_SCHEMA_HPR || schema > RECORD_SCHEMA_CURRENT ) {
+		return false;
+	}
+
+	const unsigned char *cursor = payload;
+	const unsigned char *end = payload + payloadLength;
+
+	bool success =
+		ReadValue( cursor, end, data.time ) &&
+		ReadValue( cursor, end, data.realTime ) &&
+		ReadValue( cursor, end, data.realTimeMinusTime ) &&
+		ReadValue( cursor, end, data.score ) &&
+
+		ReadValue( cursor, end, data.secondsInSlowmotion ) &&
+		ReadValue( cursor, end, data.kills ) &&
+		ReadValue( cursor, end, data.headshotKills ) &&
+		ReadValue( cursor, end, data.explosiveKills ) &&
+		ReadValue( cursor, end, data.crowbarKills ) &&
+		ReadValue( cursor, end, data.projectileKills );
+
+	data.splits.clear();
+	if ( success && schema >= RECORD_SCHEMA_SPLITS ) {
+		uint32_t splitsCount;
+		success = ReadValue( cursor, end, splitsCount ) && splitsCount <= RECORD_MAX_SPLITS;
+
+		for ( uint32_t i = 0; success && i < splitsCount; i++ ) {
+			float split;
+			success = ReadValue( cursor, end, split );
+			data.splits.push_back( split );
+		}
+	}
+
+	return success;
+}
@@ -0,0 +1,98 @@
+#ifndef CUSTOM_GAMEMODE_RECORD_STORE_H
+#define CUSTOM_GAMEMODE_RECORD_STORE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+
+const int RECORD_MAX_SPLITS = 64;
+
+// Schema 1 is the layout of legacy .hpr files (without their magic number),
+// schema 2 appends per-level splits of the best run
+enum RECORD_SCHEMA {
+	RECORD_SCHEMA_HPR = 1,
+	RECORD_SCHEMA_SPLITS = 2,
+
+	RECORD_SCHEMA_CURRENT = RECORD_SCHEMA_SPLITS
+};
+
+struct CustomGameModeRecordData {
+	float time;
+	float realTime;
+	float realTimeMinusTime;
+	int score;
+
+	float secondsInSlowmotion;
+	int kills;
+	int headshotKills;
+	int explosiveKills;
+	int crowbarKills;
+	int projectileKills;
+
+	std::vector<float> splits;
+};
+
+// All records live in a single append-only file (records\records.hpdb).
+// Every save appends a new checksummed entry, the latest valid entry for a key wins.
+// Entries that were torn by a crash fail their checksum and are skipped on load.
+// Entries are written and flushed by one writer thread, so saving never waits on the disk.
+// A records file with a foreign header is neither indexed nor appended to.
+class CustomGameModeRecordStore {
+public:
+	static CustomGameModeRecordStore &Get();
+
+	// Maps the records file once and indexes every entry, subsequent calls do nothing
+	void Load( const std::string &directoryPath );
+
+	// Picks up entries appended since the last load, e.g. by the other DLL
+	void Refresh();
+
+	bool Find( const std::string &key, CustomGameModeRecordData &data );
+	bool Import( const std::string &key, const std::string &legacyFilePath, CustomGameModeRecordData &data );
+	void Append( const std::string &key, const CustomGameModeRecordData &data );
+
+	// Writes out queued entries and stops the writer, it starts again on the next append.
+	// Blocks until the disk is done, so it's only called when the DLL is unloaded.
+	void Shutdown();
+
+private:
+	CustomGameModeRecordStore() {};
+
+	void Scan();
+	void AppendRaw( const std::string &key, uint16_t schema, const std::vector<unsigned char> &payload );
+	void WriterThread();
+	void WriteEntries( const std::deque<std::vector<unsigned char>> &entries );
+
+	static std::vector<unsigned char> Serialize( const CustomGameModeRecordData &data );
+	static bool Deserialize( uint16_t schema, const unsigned char *payload, uint32_t payloadLength, CustomGameModeRecordData &data );
+
+	std::string directoryPath;
+	std::string filePath;
+	bool loaded = false;
+	uint64_t scannedUntil = 0;
+
+	// The file was written by a newer version or isn't a records file
+	bool incompatible = false;
+
+	std::unordered_map<std::string, CustomGameModeRecordData> index;
+
+	// Keys whose legacy .hpr file was already looked for
+	std::unordered_set<std::string> checkedLegacyKeys;
+
+	// Entries waiting for the writer, each one complete with its header
+	std::deque<std::vector<unsigned char>> pendingEntries;
+	std::mutex writerMutex;
+	std::condition_variable writerWakeUp;
+	std::thread writerThread;
+	std::string writerDirectoryPath;
+	std::string writerFilePath;
+	bool writerStop = false;
+};
+
+#endif // CUSTOM_GAMEMODE_RECORD_STORE_H
@@ -313,6 +313,7 @@ void GameplayModData::AddArrayFieldDefinitions() {
 		fields.push_back( DEFINE_ARRAY( GameplayModData, gungamePriorWeapon, FIELD_CHARACTER, 128 ) );
 
 		fields.push_back( DEFINE_ARRAY( GameplayModData, endConditionsActivationCounts, FIELD_INTEGER, 64 ) );
+		fields.push_back( DEFINE_ARRAY( GameplayModData, splits, FIELD_FLOAT, 64 ) );
 		for ( int i = 0; i < 64; i++ ) {
 			fields.push_back( {
 				FIELD_CHARACTER,
@@ -243,6 +243,10 @@ public:
 	FieldInt( projectileKills, 0 );
 	FieldFloat( secondsInSlowmotion, 0.0f );
 
+	// Time at each level transition, stored with the record
+	FieldInt( splitsCount, 0 );
+	float splits[64];
+
 	char endConditionsHashes[64][128];
 	int endConditionsActivationCounts[64];
 
@@ -0,0 +1,244 @@
+//
+// pm_materials.c
+//
+// Texture name -> material type table loaded from sound/materials.txt,
+// shared by player movement, server impact sounds and client events.
+//
+
+#include <string.h>
+#include <ctype.h>
+#include "pm_materials.h"
+
+#define CTEXTURESMAX		512			// max number of textures loaded
+#define MATERIAL_HASH_SIZE	1024		// power of two, at least twice CTEXTURESMAX
+#define TEXTURE_CACHE_SIZE	1024		// power of two
+#define TEXTURE_NAME_MAX	16			// miptex name length in BSP files
+
+typedef struct
+{
+	char	name[ CBTEXTURENAMEMAX ];	// upper case, truncated like lookups are
+	char	type;
+} material_t;
+
+typedef struct
+{
+	const char	*texture;				// texture name pointer handed out by the engine
+	char		name[ TEXTURE_NAME_MAX ];
+	char		type;
+} texturematerial_t;
+
+static int					gcTextures = 0;
+static int					g_fMaterialsInit = 0;
+static material_t			grgMaterials[ CTEXTURESMAX ];
+
+// Open addressing, slot holds index + 1 into grgMaterials, 0 if empty
+static short				grgMaterialHash[ MATERIAL_HASH_SIZE ];
+
+// Texture names of a map stay at the same address, so repeated hits
+// on the same surface skip the name lookup entirely
+static texturematerial_t	grgTextureCache[ TEXTURE_CACHE_SIZE ];
+
+static char *PM_MaterialsGets( const unsigned char *pMemFile, int fileSize, int *pFilePos, char *pBuffer, int bufferSize )
+{
+	int i, last, stop, size;
+
+	if ( *pFilePos >= fileSize )
+		return NULL;
+
+	i = *pFilePos;
+	last = fileSize;
+
+	// fgets always NULL terminates, so only read bufferSize-1 characters
+	if ( last - *pFilePos > ( bufferSize - 1 ) )
+		last = *pFilePos + ( bufferSize - 1 );
+
+	stop = 0;
+
+	// Stop at the next newline (inclusive) or end of buffer
+	while ( i < last && !stop )
+	{
+		if ( pMemFile[ i ] == '\n' )
+			stop = 1;
+		i++;
+	}
+
+	if ( i == *pFilePos )
+		return NULL;
+
+	size = i - *pFilePos;
+	memcpy( pBuffer, pMemFile + *pFilePos, size );
+	pBuffer[ size ] = 0;
+
+	*pFilePos = i;
+	return pBuffer;
+}
+
+// Names compare case insensitively on the first CBTEXTURENAMEMAX-1 characters
+static void PM_NormalizeMaterialName( const char *name, char *out )
+{
+	int i;
+
+	for ( i = 0; i < CBTEXTURENAMEMAX - 1 && name[ i ]; i++ )
+		out[ i ] = toupper( (unsigned char)name[ i ] );
+
+	out[ i ] = 0;
+}
+
+static unsigned int PM_HashMaterialName( const char *normalized )
+{
+	unsigned int hash = 2166136261u;
+
+	while ( *normalized )
+	{
+		hash ^= (unsigned char)*normalized++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static void PM_AddMaterial( const char *name, char type )
+{
+	char normalized[ CBTEXTURENAMEMAX ];
+	unsigned int slot;
+	int index;
+
+	PM_NormalizeMaterialName( name, normalized );
+
+	slot = PM_HashMaterialName( normalized ) & ( MATERIAL_HASH_SIZE - 1 );
+	while ( ( index = grgMaterialHash[ slot ] ) != 0 )
+	{
+		// First entry in the file wins
+		if ( !strcmp( grgMaterials[ index - 1 ].name, normalized ) )
+			return;
+
+		slot = ( slot + 1 ) & ( MATERIAL_HASH_SIZE - 1 );
+	}
+
+	strcpy( grgMaterials[ gcTextures ].name, normalized );
+	grgMaterials[ gcTextures ].type = type;
+	grgMaterialHash[ slot ] = ++gcTextures;
+}
+
+int PM_MaterialsInitialized( void )
+{
+	return g_fMaterialsInit;
+}
+
+void PM_InitMaterials( const unsigned char *pMemFile, int fileSize )
+{
+	char buffer[512];
+	int i, j;
+	int filePos = 0;
+	char type;
+
+	if ( g_fMaterialsInit )
+		return;
+
+	gcTextures = 0;
+	memset( grgMaterials, 0, sizeof( grgMaterials ) );
+	memset( grgMaterialHash, 0, sizeof( grgMaterialHash ) );
+	memset( buffer, 0, 512 );
+
+	if ( !pMemFile )
+		return;
+
+	// for each line in the file...
+	while ( PM_MaterialsGets( pMemFile, fileSize, &filePos, buffer, 511 ) != NULL && ( gcTextures < CTEXTURESMAX ) )
+	{
+		// skip whitespace
+		i = 0;
+		while ( buffer[i] && isspace( buffer[i] ) )
+			i++;
+
+		if ( !buffer[i] )
+			continue;
+
+		// skip comment lines
+		if ( buffer[i] == '/' || !isalpha( buffer[i] ) )
+			continue;
+
+		// get texture type
+		type = toupper( buffer[i++] );
+
+		// skip whitespace
+		while ( buffer[i] && isspace( buffer[i] ) )
+			i++;
+
+		if ( !buffer[i] )
+			continue;
+
+		// get texture name
+		j = i;
+		while ( buffer[j] && !isspace( buffer[j] ) )
+			j++;
+
+		if ( !buffer[j] )
+			continue;
+
+		buffer[j] = 0;
+		PM_AddMaterial( &buffer[i], type );
+	}
+
+	PM_ClearMaterialCache();
+
+	g_fMaterialsInit = 1;
+}
+
+char PM_FindMaterial( const char *name )
+{
+	char normalized[ CBTEXTURENAMEMAX ];
+	unsigned int slot;
+	int index;
+
+	PM_NormalizeMaterialName( name, normalized );
+
+	slot = PM_HashMaterialName( normalized ) & ( MATERIAL_HASH_SIZE - 1 );
+	while ( ( index = grgMaterialHash[ slot ] ) != 0 )
+	{
+		if ( !strcmp( grgMaterials[ index - 1 ].name, normalized ) )
+			return grgMaterials[ index - 1 ].type;
+
+		slot = ( slot + 1 ) & ( MATERIAL_HASH_SIZE - 1 );
+	}
+
+	return CHAR_TEX_CONCRETE;
+}
+
+const char *PM_StripTexturePrefix( const char *textureName )
+{
+	// strip leading '-0' or '+0~' or '{' or '!'
+	if ( *textureName == '-' || *textureName == '+' )
+		textureName += 2;
+
+	if ( *textureName == '{' || *textureName == '!' || *textureName == '~' || *textureName == ' ' )
+		textureName++;
+	// '}}'
+
+	return textureName;
+}
+
+char PM_TextureMaterial( const char *textureName )
+{
+	texturematerial_t *pcache;
+	size_t slot;
+
+	slot = ( (size_t)textureName >> 2 ) & ( TEXTURE_CACHE_SIZE - 1 );
+	pcache = &grgTextureCache[ slot ];
+
+	// Name is compared as well, in case the address got reused for another texture
+	if ( pcache->texture != textureName || strncmp( pcache->name, textureName, TEXTURE_NAME_MAX - 1 ) )
+	{
+		pcache->texture = textureName;
+		strncpy( pcache->name, textureName, TEXTURE_NAME_MAX - 1 );
+		pcache->name[ TEXTURE_NAME_MAX - 1 ] = 0;
+		pcache->type = PM_FindMaterial( PM_StripTexturePrefix( textureName ) );
+	}
+
+	return pcache->type;
+}
+
+void PM_ClearMaterialCache( void )
+{
+	memset( grgTextureCache, 0, sizeof( grgTextureCache ) );
+}
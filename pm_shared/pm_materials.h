@@ -31,4 +31,26 @@
 #define CHAR_TEX_FLESH		'F'
 #define CHAR_TEX_SNOW		'N'
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Parses materials.txt once, later calls are ignored
+void PM_InitMaterials( const unsigned char *pMemFile, int fileSize );
+int PM_MaterialsInitialized( void );
+
+// Material of a texture name without prefix, CHAR_TEX_CONCRETE if unknown
+char PM_FindMaterial( const char *name );
+
+// Material of a texture name as returned by texture traces, cached per texture
+char PM_TextureMaterial( const char *textureName );
+const char *PM_StripTexturePrefix( const char *textureName );
+
+// Texture names move when the map changes
+void PM_ClearMaterialCache( void );
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // !PM_MATERIALSH
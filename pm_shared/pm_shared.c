@@ -21,6 +21,7 @@
 #include "pm_shared.h"
 #include "pm_movevars.h"
 #include "pm_debug.h"
+#include "pm_materials.h"
 #include <stdio.h>  // NULL
 #include <math.h>   // sqrt
 #include <string.h> // strcpy
@@ -89,21 +90,6 @@ typedef struct hull_s
 #define VEC_VIEW			28
 #define	STOP_EPSILON		0.1
 
-#define CTEXTURESMAX		512			// max number of textures loaded
-#define CBTEXTURENAMEMAX	13			// only load first n chars of name
-
-#define CHAR_TEX_CONCRETE	'C'			// texture types
-#define CHAR_TEX_METAL		'M'
-#define CHAR_TEX_DIRT		'D'
-#define CHAR_TEX_VENT		'V'
-#define CHAR_TEX_GRATE		'G'
-#define CHAR_TEX_TILE		'T'
-#define CHAR_TEX_SLOSH		'S'
-#define CHAR_TEX_WOOD		'W'
-#define CHAR_TEX_COMPUTER	'P'
-#define CHAR_TEX_GLASS		'Y'
-#define CHAR_TEX_FLESH		'F'
-
 #define STEP_CONCRETE	0		// default step sound
 #define STEP_METAL		1		// metal floor
 #define STEP_DIRT		2		// dirt, sand, rock
@@ -149,11 +135,6 @@ typedef struct hull_s
 static vec3_t rgv3tStuckTable[54];
 static int rgStuckLast[MAX_CLIENTS][2];
 
-// Texture names
-static int gcTextures = 0;
-static char grgszTextureName[CTEXTURESMAX][CBTEXTURENAMEMAX];	
-static char grgchTextureType[CTEXTURESMAX];
-
 int g_onladder = 0;
 int g_slowMotionCharge = 0;
 int g_divingAllowedWithoutSlowmotion = 0;
@@ -183,141 +164,30 @@ int lastReverseGravity = 0;
 
 void PM_DuckWhileDiving(void);
 
-void PM_SwapTextures( int i, int j )
-{
-	char chTemp;
-	char szTemp[ CBTEXTURENAMEMAX ];
-
-	strcpy( szTemp, grgszTextureName[ i ] );
-	chTemp = grgchTextureType[ i ];
-	
-	strcpy( grgszTextureName[ i ], grgszTextureName[ j ] );
-	grgchTextureType[ i ] = grgchTextureType[ j ];
-
-	strcpy( grgszTextureName[ j ], szTemp );
-	grgchTextureType[ j ] = chTemp;
-}
-
-void PM_SortTextures( void )
-{
-	// Bubble sort, yuck, but this only occurs at startup and it's only 512 elements...
-	//
-	int i, j;
-
-	for ( i = 0 ; i < gcTextures; i++ )
-	{
-		for ( j = i + 1; j < gcTextures; j++ )
-		{
-			if ( stricmp( grgszTextureName[ i ], grgszTextureName[ j ] ) > 0 )
-			{
-				// Swap
-				//
-				PM_SwapTextures( i, j );
-			}
-		}
-	}
-}
-
 void PM_InitTextureTypes()
 {
-	char buffer[512];
-	int i, j;
 	byte *pMemFile;
-	int fileSize, filePos;
-	static qboolean bTextureTypeInit = false;
+	int fileSize;
 
-	if ( bTextureTypeInit )
+	if ( PM_MaterialsInitialized() )
 		return;
 
-	memset(&(grgszTextureName[0][0]), 0, CTEXTURESMAX * CBTEXTURENAMEMAX);
-	memset(grgchTextureType, 0, CTEXTURESMAX);
-
-	gcTextures = 0;
-	memset(buffer, 0, 512);
-
 	fileSize = pmove->COM_FileSize( "sound/materials.txt" );
 	pMemFile = pmove->COM_LoadFile( "sound/materials.txt", 5, NULL );
 	if ( !pMemFile )
 		return;
 
-	filePos = 0;
-	// for each line in the file...
-	while ( pmove->memfgets( pMemFile, fileSize, &filePos, buffer, 511 ) != NULL && (gcTextures < CTEXTURESMAX) )
-	{
-		// skip whitespace
-		i = 0;
-		while(buffer[i] && isspace(buffer[i]))
-			i++;
-		
-		if (!buffer[i])
-			continue;
-
-		// skip comment lines
-		if (buffer[i] == '/' || !isalpha(buffer[i]))
-			continue;
-
-		// get texture type
-		grgchTextureType[gcTextures] = toupper(buffer[i++]);
-
-		// skip whitespace
-		while(buffer[i] && isspace(buffer[i]))
-			i++;
-		
-		if (!buffer[i])
-			continue;
-
-		// get sentence name
-		j = i;
-		while (buffer[j] && !isspace(buffer[j]))
-			j++;
-
-		if (!buffer[j])
-			continue;
-
-		// null-terminate name and save in sentences array
-		j = min (j, CBTEXTURENAMEMAX-1+i);
-		buffer[j] = 0;
-		strcpy(&(grgszTextureName[gcTextures++][0]), &(buffer[i]));
-	}
+	PM_InitMaterials( pMemFile, fileSize );
 
 	// Must use engine to free since we are in a .dll
 	pmove->COM_FreeFile ( pMemFile );
-
-	PM_SortTextures();
-
-	bTextureTypeInit = true;
 }
 
 char PM_FindTextureType( char *name )
 {
-	int left, right, pivot;
-	int val;
-
 	assert( pm_shared_initialized );
 
-	left = 0;
-	right = gcTextures - 1;
-
-	while ( left <= right )
-	{
-		pivot = ( left + right ) / 2;
-
-		val = strnicmp( name, grgszTextureName[ pivot ], CBTEXTURENAMEMAX-1 );
-		if ( val == 0 )
-		{
-			return grgchTextureType[ pivot ];
-		}
-		else if ( val > 0 )
-		{
-			left = pivot + 1;
-		}
-		else if ( val < 0 )
-		{
-			right = pivot - 1;
-		}
-	}
-
-	return CHAR_TEX_CONCRETE;
+	return PM_FindMaterial( name );
 }
 
 void PM_PlayStepSound( int step, float fvol )
@@ -509,19 +379,11 @@ void PM_CatagorizeTextureType( void )
 	if ( !pTextureName )
 		return;
 
-	// strip leading '-0' or '+0~' or '{' or '!'
-	if (*pTextureName == '-' || *pTextureName == '+')
-		pTextureName += 2;
-
-	if (*pTextureName == '{' || *pTextureName == '!' || *pTextureName == '~' || *pTextureName == ' ')
-		pTextureName++;
-	// '}}'
-	
-	strcpy( pmove->sztexturename, pTextureName);
+	strcpy( pmove->sztexturename, PM_StripTexturePrefix( pTextureName ) );
 	pmove->sztexturename[ CBTEXTURENAMEMAX - 1 ] = 0;
 		
 	// get texture type
-	pmove->chtexturetype = PM_FindTextureType( pmove->sztexturename );	
+	pmove->chtexturetype = PM_TextureMaterial( pTextureName );	
 }
 
 void PM_UpdateStepSound( void )
@@ -8,6 +8,13 @@
 *
 ****/
 
+#ifdef WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#endif
+
 #include "cmdlib.h"
 #include "mathlib.h"
 #include "bspfile.h"
@@ -324,8 +331,103 @@ void SwapBSPFile (qboolean todisk)
 
 
 dheader_t	*header;
+dheader_t	inheader;
+
+byte		*bspbase;
+int			bsplength;
+qboolean	bspmapped;
+
+char		*lumpnames[HEADER_LUMPS] =
+{
+	"entities", "planes", "textures", "vertexes", "visibility",
+	"nodes", "texinfo", "faces", "lighting", "clipnodes",
+	"leafs", "marksurfaces", "edges", "surfedges", "models"
+};
+
+/*
+=============
+MapBSPFile
+
+Maps the file into memory, or reads all of it when that fails
+=============
+*/
+void MapBSPFile (char *filename)
+{
+	FILE	*f;
+#ifdef WIN32
+	HANDLE	mapping;
+#endif
+
+	f = SafeOpenRead (filename);
+	bsplength = filelength (f);
+	bspbase = NULL;
+	bspmapped = false;
+
+#ifdef WIN32
+	mapping = CreateFileMapping ((HANDLE)_get_osfhandle (fileno (f)), NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping)
+	{
+		bspbase = MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle (mapping);	// the view keeps the mapping alive
+	}
+#else
+	if (bsplength)
+	{
+		bspbase = mmap (NULL, bsplength, PROT_READ, MAP_SHARED, fileno (f), 0);
+		if (bspbase == MAP_FAILED)
+			bspbase = NULL;
+	}
+#endif
+
+	if (bspbase)
+		bspmapped = true;
+	else
+	{
+		bspbase = malloc (bsplength + 1);
+		SafeRead (f, bspbase, bsplength);
+	}
+
+	fclose (f);
+}
+
+void UnmapBSPFile (void)
+{
+	if (bspmapped)
+	{
+#ifdef WIN32
+		UnmapViewOfFile (bspbase);
+#else
+		munmap (bspbase, bsplength);
+#endif
+	}
+	else
+		free (bspbase);
+	bspbase = NULL;
+}
+
+/*
+=============
+CheckBSPHeader
 
-int CopyLump (int lump, void *dest, int size)
+Every lump has to lie inside the file before anything is copied out of it
+=============
+*/
+void CheckBSPHeader (char *filename)
+{
+	int		i, ofs, length;
+
+	for (i=0 ; i<HEADER_LUMPS ; i++)
+	{
+		ofs = header->lumps[i].fileofs;
+		length = header->lumps[i].filelen;
+
+		if (ofs < 0 || length < 0 || ofs > bsplength || length > bsplength - ofs)
+			Error ("%s has a bad %s lump (offset %i, length %i, file is %i bytes)",
+				filename, lumpnames[i], ofs, length, bsplength);
+	}
+}
+
+int CopyLump (int lump, void *dest, int size, int maxsize)
 {
 	int		length, ofs;
 
@@ -333,9 +435,11 @@ int CopyLump (int lump, void *dest, int size)
 	ofs = header->lumps[lump].fileofs;
 	
 	if (length % size)
-		Error ("LoadBSPFile: odd lump size");
+		Error ("LoadBSPFile: odd %s lump size", lumpnames[lump]);
+	if (length > maxsize)
+		Error ("LoadBSPFile: %s lump is %i bytes, limit is %i", lumpnames[lump], length, maxsize);
 	
-	memcpy (dest, (byte *)header + ofs, length);
+	memcpy (dest, bspbase + ofs, length);
 
 	return length / size;
 }
@@ -352,38 +456,46 @@ void	LoadBSPFile (char *filename)
 //
 // load the file header
 //
-	LoadFile (filename, (void **)&header);
+	MapBSPFile (filename);
+
+	if (bsplength < (int)sizeof(dheader_t))
+		Error ("%s is too short to be a bsp file", filename);
 
 // swap the header
+	header = &inheader;
+	memcpy (header, bspbase, sizeof(dheader_t));
 	for (i=0 ; i< sizeof(dheader_t)/4 ; i++)
 		((int *)header)[i] = LittleLong ( ((int *)header)[i]);
 
 	if (header->version != BSPVERSION)
 		Error ("%s is version %i, not %i", filename, header->version, BSPVERSION);
 
-	nummodels = CopyLump (LUMP_MODELS, dmodels, sizeof(dmodel_t));
-	numvertexes = CopyLump (LUMP_VERTEXES, dvertexes, sizeof(dvertex_t));
-	numplanes = CopyLump (LUMP_PLANES, dplanes, sizeof(dplane_t));
-	numleafs = CopyLump (LUMP_LEAFS, dleafs, sizeof(dleaf_t));
-	numnodes = CopyLump (LUMP_NODES, dnodes, sizeof(dnode_t));
-	numtexinfo = CopyLump (LUMP_TEXINFO, texinfo, sizeof(texinfo_t));
-	numclipnodes = CopyLump (LUMP_CLIPNODES, dclipnodes, sizeof(dclipnode_t));
-	numfaces = CopyLump (LUMP_FACES, dfaces, sizeof(dface_t));
-	nummarksurfaces = CopyLump (LUMP_MARKSURFACES, dmarksurfaces, sizeof(dmarksurfaces[0]));
-	numsurfedges = CopyLump (LUMP_SURFEDGES, dsurfedges, sizeof(dsurfedges[0]));
-	numedges = CopyLump (LUMP_EDGES, dedges, sizeof(dedge_t));
-
-	texdatasize = CopyLump (LUMP_TEXTURES, dtexdata, 1);
-	visdatasize = CopyLump (LUMP_VISIBILITY, dvisdata, 1);
-	lightdatasize = CopyLump (LUMP_LIGHTING, dlightdata, 1);
-	entdatasize = CopyLump (LUMP_ENTITIES, dentdata, 1);
-
-	free (header);		// everything has been copied out
+	CheckBSPHeader (filename);
+
+	nummodels = CopyLump (LUMP_MODELS, dmodels, sizeof(dmodel_t), sizeof(dmodels));
+	numvertexes = CopyLump (LUMP_VERTEXES, dvertexes, sizeof(dvertex_t), sizeof(dvertexes));
+	numplanes = CopyLump (LUMP_PLANES, dplanes, sizeof(dplane_t), sizeof(dplanes));
+	numleafs = CopyLump (LUMP_LEAFS, dleafs, sizeof(dleaf_t), sizeof(dleafs));
+	numnodes = CopyLump (LUMP_NODES, dnodes, sizeof(dnode_t), sizeof(dnodes));
+	numtexinfo = CopyLump (LUMP_TEXINFO, texinfo, sizeof(texinfo_t), sizeof(texinfo));
+	numclipnodes = CopyLump (LUMP_CLIPNODES, dclipnodes, sizeof(dclipnode_t), sizeof(dclipnodes));
+	numfaces = CopyLump (LUMP_FACES, dfaces, sizeof(dface_t), sizeof(dfaces));
+	nummarksurfaces = CopyLump (LUMP_MARKSURFACES, dmarksurfaces, sizeof(dmarksurfaces[0]), sizeof(dmarksurfaces));
+	numsurfedges = CopyLump (LUMP_SURFEDGES, dsurfedges, sizeof(dsurfedges[0]), sizeof(dsurfedges));
+	numedges = CopyLump (LUMP_EDGES, dedges, sizeof(dedge_t), sizeof(dedges));
+
+	texdatasize = CopyLump (LUMP_TEXTURES, dtexdata, 1, sizeof(dtexdata));
+	visdatasize = CopyLump (LUMP_VISIBILITY, dvisdata, 1, sizeof(dvisdata));
+	lightdatasize = CopyLump (LUMP_LIGHTING, dlightdata, 1, sizeof(dlightdata));
+	entdatasize = CopyLump (LUMP_ENTITIES, dentdata, 1, sizeof(dentdata));
+
+	UnmapBSPFile ();		// everything has been copied out
 		
 //
-// swap everything
+// swap everything, the file is already in host order on little endian machines
 //	
-	SwapBSPFile (false);
+	if (LittleLong (1) != 1)
+		SwapBSPFile (false);
 
 	dmodels_checksum = FastChecksum( dmodels, nummodels*sizeof(dmodels[0]) );
     dvertexes_checksum = FastChecksum( dvertexes, numvertexes*sizeof(dvertexes[0]) );
@@ -431,7 +543,8 @@ void	WriteBSPFile (char *filename)
 	header = &outheader;
 	memset (header, 0, sizeof(dheader_t));
 	
-	SwapBSPFile (true);
+	if (LittleLong (1) != 1)
+		SwapBSPFile (true);
 
 	header->version = LittleLong (BSPVERSION);
 	
@@ -32,6 +32,10 @@ qboolean clamp192 = true;
 
 float		minlights[MAX_MAP_FACES];
 
+// lightmaps of each face until they are copied into the lump
+byte		*facelightdata[MAX_MAP_FACES];
+int			facelightsize[MAX_MAP_FACES];
+
 lightentity_t	lightentities[MAX_MAP_ENTITIES];
 int		numlightentities;
 
@@ -130,15 +134,32 @@ byte *GetFileSpace (int size)
 /*
 =============
 LightWorld
+
+Faces are lit on all threads, then their lightmaps are laid out in face
+order so the lump doesn't depend on which thread finished first.
 =============
 */
 void LightWorld (void)
 {
+	int		i;
+	byte	*out;
+
 	filebase = file_p = dlightdata;
 	file_end = filebase + MAX_MAP_LIGHTING;
 
 	RunThreadsOnIndividual (numfaces, true, LightFace);
 
+	for (i=0 ; i<numfaces ; i++)
+	{
+		if (!facelightdata[i])
+			continue;
+		out = GetFileSpace (facelightsize[i]);
+		memcpy (out, facelightdata[i], facelightsize[i]);
+		dfaces[i].lightofs = out - filebase;
+		free (facelightdata[i]);
+		facelightdata[i] = NULL;
+	}
+
 	lightdatasize = file_p - filebase;
 	
 	printf ("lightdatasize: %i\n", lightdatasize);
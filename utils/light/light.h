@@ -58,3 +58,6 @@ void RotateSample (vec3_t in, vec3_t out);
 extern	qboolean	extrasamples;
 
 extern	float		minlights[MAX_MAP_FACES];
+
+extern	byte		*facelightdata[MAX_MAP_FACES];
+extern	int			facelightsize[MAX_MAP_FACES];
@@ -446,6 +446,46 @@ void SingleLightFace (lightentity_t *light, lightinfo_t *l)
 	}
 }
 
+/*
+================
+LightInRange
+
+Lights fall off linearly, so a light can't add anything to a sample
+further away than its brightest color.  The closest sample is at least
+as far as the box around all of them.  A little slack is left for
+rounding, culled lights would only have added nothing.
+================
+*/
+qboolean LightInRange (lightentity_t *light, vec3_t mins, vec3_t maxs)
+{
+	int		i;
+	vec_t	d, dist, maxlight;
+
+	if (scaledist <= 0)
+		return true;
+
+	dist = 0;
+	for (i=0 ; i<3 ; i++)
+	{
+		if (light->origin[i] < mins[i])
+			d = mins[i] - light->origin[i];
+		else if (light->origin[i] > maxs[i])
+			d = light->origin[i] - maxs[i];
+		else
+			continue;
+		dist += d*d;
+	}
+	dist = sqrt(dist) * scaledist;
+
+	maxlight = light->light[0];
+	if (light->light[1] > maxlight)
+		maxlight = light->light[1];
+	if (light->light[2] > maxlight)
+		maxlight = light->light[2];
+
+	return dist <= maxlight + 1;
+}
+
 /*
 ============
 FixMinlight
@@ -516,6 +556,8 @@ void LightFace (int surfnum)
 	byte	*out;
 	vec3_t	*light;
 	int		w, h;
+	vec3_t	mins, maxs;
+	vec_t	*surf;
 	int		clamp = 192;
 	float	clampfactor = 0.75;
 	
@@ -570,11 +612,19 @@ void LightFace (int surfnum)
 		l.lightstyles[i] = 255;
 	
 //
-// cast all lights
+// cast all lights that can reach a sample, in entity order
 //	
+	ClearBounds (mins, maxs);
+	for (c=0, surf=l.surfpt[0] ; c<l.numsurfpt ; c++, surf+=3)
+		AddPointToBounds (surf, mins, maxs);
+
 	l.numlightstyles = 0;
 	for (i=0 ; i<numlightentities ; i++)
+	{
+		if (!LightInRange (&lightentities[i], mins, maxs))
+			continue;
 		SingleLightFace (&lightentities[i], &l);
+	}
 
 	FixMinlight (&l);
 		
@@ -594,8 +644,10 @@ void LightFace (int surfnum)
 	else
 		lightmapsize = size * l.numlightstyles;
 
-	out = GetFileSpace (lightmapsize);
-	f->lightofs = out - filebase;
+	// LightWorld moves it into the lump in face order
+	out = malloc (lightmapsize);
+	facelightdata[surfnum] = out;
+	facelightsize[surfnum] = lightmapsize;
 	
 // extra filtering
 	h = (l.texsize[1]+1)*2;
@@ -160,6 +160,163 @@ surface_t *ChooseMidPlaneFromList (surface_t *surfaces, vec3_t mins, vec3_t maxs
 
 
 
+/*
+==================
+SurfaceCrossesPlane
+
+False if the bounding box of the surface is far enough to one side of
+split that FaceSide can't return SIDE_ON for any of its faces.
+==================
+*/
+qboolean SurfaceCrossesPlane (surface_t *surf, dplane_t *split)
+{
+	int		i;
+	vec_t	front, back;
+
+	// same test FaceSide does on the points
+	if (split->type < 3)
+		return surf->maxs[split->type] > split->dist + ON_EPSILON
+			&& surf->mins[split->type] < split->dist - ON_EPSILON;
+
+	front = back = -split->dist;
+	for (i=0 ; i<3 ; i++)
+	{
+		if (split->normal[i] > 0)
+		{
+			front += split->normal[i] * surf->maxs[i];
+			back += split->normal[i] * surf->mins[i];
+		}
+		else
+		{
+			front += split->normal[i] * surf->mins[i];
+			back += split->normal[i] * surf->maxs[i];
+		}
+	}
+
+	// half an epsilon of slack for rounding between corners and points
+	return front > ON_EPSILON * 0.5 && back < -ON_EPSILON * 0.5;
+}
+
+/*
+==================
+CountPlaneSplits
+
+Counts the faces the plane of p would split, stopping once the count
+is known to be over maxsplits.
+==================
+*/
+int CountPlaneSplits (surface_t *surfaces, surface_t *p, int maxsplits)
+{
+	int			k;
+	surface_t	*p2;
+	dplane_t	*plane;
+	face_t		*f;
+
+	plane = &dplanes[p->planenum];
+	k = 0;
+
+	for (p2=surfaces ; p2 ; p2=p2->next)
+	{
+		if (p2 == p)
+			continue;
+		if (p2->onnode)
+			continue;
+		if (!SurfaceCrossesPlane (p2, plane))
+			continue;
+
+		for (f=p2->faces ; f ; f=f->next)
+		{
+			if (FaceSide (f, plane) == SIDE_ON)
+			{
+				k++;
+				if (k >= maxsplits)
+					break;
+			}
+			
+		}
+		if (k > maxsplits)
+			break;
+	}
+
+	return k;
+}
+
+/*
+==================
+Threaded split counting
+
+With many candidates at a node the split counts are found on all threads
+first.  CountPlaneSplits stops early, and the count it stops at is what
+decides ties, so each thread keeps the exact count and the count before
+the last surface with any split faces.  TruncatedSplits works out from
+those what CountPlaneSplits would have returned, and ChoosePlaneFromList
+goes through them in list order, so it picks the same plane either way.
+==================
+*/
+#define	MIN_THREADED_CANDIDATES	64
+
+surface_t	*splitsurfaces;
+surface_t	**splitcandidates;
+int			*splitcounts;
+int			*splitcountsbeforelast;
+
+void CountPlaneSplitsThread (int i)
+{
+	int			k, beforelast, c;
+	surface_t	*p, *p2;
+	dplane_t	*plane;
+	face_t		*f;
+
+	p = splitcandidates[i];
+	plane = &dplanes[p->planenum];
+	k = beforelast = 0;
+
+	for (p2=splitsurfaces ; p2 ; p2=p2->next)
+	{
+		if (p2 == p)
+			continue;
+		if (p2->onnode)
+			continue;
+		if (!SurfaceCrossesPlane (p2, plane))
+			continue;
+
+		c = 0;
+		for (f=p2->faces ; f ; f=f->next)
+			if (FaceSide (f, plane) == SIDE_ON)
+				c++;
+
+		if (c)
+		{
+			beforelast = k;
+			k += c;
+		}
+	}
+
+	splitcounts[i] = k;
+	splitcountsbeforelast[i] = beforelast;
+}
+
+/*
+==================
+TruncatedSplits
+
+What CountPlaneSplits returns for maxsplits, given the exact count and
+the count before the last surface with split faces.  Counting stops as
+soon as maxsplits is reached, and one more surface with split faces
+after that makes it maxsplits + 1.
+==================
+*/
+int TruncatedSplits (int count, int beforelast, int maxsplits)
+{
+	if (!count)
+		return 0;
+	if (count < maxsplits)
+		return count;
+	if (beforelast < maxsplits)
+		return maxsplits;
+	return maxsplits + 1;
+}
+
 /*
 ==================
 ChoosePlaneFromList
@@ -170,17 +327,42 @@ Choose the plane that splits the least faces
 surface_t *ChoosePlaneFromList (surface_t *surfaces, vec3_t mins, vec3_t maxs)
 {
 	int			j,k,l;
-	surface_t	*p, *p2, *bestsurface;
+	int			candidate, numcandidates;
+	surface_t	*p, *bestsurface;
 	vec_t		bestvalue, bestdistribution, value, dist;
 	dplane_t		*plane;
-	face_t		*f;
-	
+	int			*counts, *beforelast;
+
+	numcandidates = 0;
+	for (p=surfaces ; p ; p=p->next)
+		if (!p->onnode)
+			numcandidates++;
+
+	counts = beforelast = NULL;
+	if (numthreads > 1 && numcandidates >= MIN_THREADED_CANDIDATES)
+	{
+		splitsurfaces = surfaces;
+		splitcandidates = malloc (numcandidates * sizeof(*splitcandidates));
+		splitcounts = counts = malloc (numcandidates * sizeof(*splitcounts));
+		splitcountsbeforelast = beforelast = malloc (numcandidates * sizeof(*splitcountsbeforelast));
+
+		candidate = 0;
+		for (p=surfaces ; p ; p=p->next)
+			if (!p->onnode)
+				splitcandidates[candidate++] = p;
+
+		RunThreadsOnIndividual (numcandidates, false, CountPlaneSplitsThread);
+
+		free (splitcandidates);
+	}
+
 //
 // pick the plane that splits the least
 //
 	bestvalue = 99999;
 	bestsurface = NULL;
 	bestdistribution = 9e30;
+	candidate = 0;
 	
 	for (p=surfaces ; p ; p=p->next)
 	{
@@ -188,28 +370,14 @@ surface_t *ChoosePlaneFromList (surface_t *surfaces, vec3_t mins, vec3_t maxs)
 			continue;
 
 		plane = &dplanes[p->planenum];
-		k = 0;
 
-		for (p2=surfaces ; p2 ; p2=p2->next)
+		if (counts)
 		{
-			if (p2 == p)
-				continue;
-			if (p2->onnode)
-				continue;
-				
-			for (f=p2->faces ; f ; f=f->next)
-			{
-				if (FaceSide (f, plane) == SIDE_ON)
-				{
-					k++;
-					if (k >= bestvalue)
-						break;
-				}
-				
-			}
-			if (k > bestvalue)
-				break;
+			k = TruncatedSplits (counts[candidate], beforelast[candidate], (int)bestvalue);
+			candidate++;
 		}
+		else
+			k = CountPlaneSplits (surfaces, p, (int)bestvalue);
 
 		if (k > bestvalue)
 			continue;
@@ -253,6 +421,11 @@ surface_t *ChoosePlaneFromList (surface_t *surfaces, vec3_t mins, vec3_t maxs)
 
 	}
 
+	if (counts)
+	{
+		free (counts);
+		free (beforelast);
+	}
 
 	return bestsurface;
 }
@@ -80,6 +80,77 @@ int	PlaneTypeForNormal (vec3_t normal)
 	return PLANE_ANYZ;
 }
 
+/*
+=============
+PlaneHash
+
+Planes are hashed on their reduced integer normal and the dot product of
+that normal with the origin, which is the same for every integer point on
+the plane.  The dot product wraps the same way the point-on-plane test in
+FindIntPlane used to, so the same planes compare equal.
+
+Lookups don't take the lock.  A new plane is completely filled in and
+chained before it is published in planehash, so another thread either
+misses it and looks again under the lock, or sees all of it.  The chain
+heads are only read and written with interlocked calls, which are full
+barriers.
+=============
+*/
+#define	PLANE_HASHES	(MAX_MAP_PLANES/2)
+
+static LONG	volatile planehash[PLANE_HASHES];	// plane number + 1, 0 ends a chain
+static int	planechain[MAX_MAP_PLANES];		// next plane number + 1 in the same chain
+
+static unsigned PlaneDistKey (int *inormal, int *iorigin)
+{
+	return (unsigned)inormal[0] * (unsigned)iorigin[0]
+		+ (unsigned)inormal[1] * (unsigned)iorigin[1]
+		+ (unsigned)inormal[2] * (unsigned)iorigin[2];
+}
+
+static unsigned PlaneHash (int *inormal, unsigned dist)
+{
+	unsigned	hash;
+
+	hash = (unsigned)inormal[0] * 73856093;
+	hash ^= (unsigned)inormal[1] * 19349663;
+	hash ^= (unsigned)inormal[2] * 83492791;
+	hash ^= dist * 2654435761u;
+	hash ^= hash >> 15;
+
+	return hash % PLANE_HASHES;
+}
+
+static int PlaneHashFind (int *inormal, unsigned dist, unsigned hash)
+{
+	int		i;
+	plane_t	*p;
+
+	for (i = InterlockedExchangeAdd (&planehash[hash], 0) - 1 ; i >= 0 ; i = planechain[i] - 1)
+	{
+		p = &mapplanes[i];
+		if (p->inormal[0] == inormal[0]
+		&& p->inormal[1] == inormal[1]
+		&& p->inormal[2] == inormal[2]
+		&& PlaneDistKey (p->inormal, p->iorigin) == dist)
+			return i;
+	}
+
+	return -1;
+}
+
+static void PlaneHashAdd (int planenum)
+{
+	plane_t		*p;
+	unsigned	hash;
+
+	p = &mapplanes[planenum];
+	hash = PlaneHash (p->inormal, PlaneDistKey (p->inormal, p->iorigin));
+
+	planechain[planenum] = planehash[hash];
+	InterlockedExchange (&planehash[hash], planenum + 1);
+}
+
 /*
 =============
 FindIntPlane
@@ -90,98 +161,152 @@ Returns which plane number to use for a given integer defined plane.
 */
 int		FindIntPlane (int *inormal, int *iorigin)
 {
-	int		i, j;
-	plane_t	*p, temp;
-	int		t;
-	vec3_t	origin;
-	qboolean	locked;
+	int		i, j, planenum, side;
+	plane_t	*p;
+	vec_t	length;
+	unsigned	dist, hash;
 
 	FindGCD (inormal);
 
-	p = mapplanes;
-	locked = false;
-	i = 0;
+	dist = PlaneDistKey (inormal, iorigin);
+	hash = PlaneHash (inormal, dist);
 
-	while (1)
-	{
-		if (i == nummapplanes)
-		{
-			if (!locked)
-			{
-				locked = true;
-				ThreadLock ();	// make sure we don't race
-			}
-			if (i == nummapplanes)
-				break;		// we didn't race
-		}
+	i = PlaneHashFind (inormal, dist, hash);
+	if (i != -1)
+		return i;
 
-		// see if origin is on plane
-		t = 0;
-		for (j=0 ; j<3 ; j++)
-			t += (iorigin[j] - p->iorigin[j]) * inormal[j];
-		if (!t)
-		{	// on plane
-
-			// see if the normal is forward, backwards, or off
-			for (j=0 ; j<3 ; j++)
-				if (inormal[j] != p->inormal[j])
-					break;
-			if (j == 3)
-			{
-				if (locked)
-					ThreadUnlock ();
-				return i;
-			}
-		}
+	ThreadLock ();	// make sure we don't race
 
-		i++;
-		p++;
+	i = PlaneHashFind (inormal, dist, hash);
+	if (i != -1)
+	{
+		ThreadUnlock ();
+		return i;
 	}
 
-	if (!locked)
-		Error ("not locked");
+	if (nummapplanes + 2 > MAX_MAP_PLANES)
+		Error ("MAX_MAP_PLANES");
+
+	// allways put the plane whose first nonzero normal component is
+	// positive first, so axial planes face positive and the pair comes
+	// out the same whichever side was asked for first
+	for (j=0 ; j<3 && !inormal[j] ; j++)
+		;
+	side = (j < 3 && inormal[j] < 0);
 
 	// create a new plane
+	i = nummapplanes;
+	planenum = i + side;
+	p = &mapplanes[i];
+
 	for (j=0 ; j<3 ; j++)
 	{
-		p->inormal[j] = inormal[j];
-		(p+1)->inormal[j] = -inormal[j];
+		p->inormal[j] = side ? -inormal[j] : inormal[j];
+		(p+1)->inormal[j] = -p->inormal[j];
 		p->iorigin[j] = iorigin[j];
 		(p+1)->iorigin[j] = iorigin[j];
 
-		p->normal[j] = inormal[j];
-		origin[j] = iorigin[j];
+		p->normal[j] = p->inormal[j];
 	}
 
-	if (nummapplanes >= MAX_MAP_PLANES)
-		Error ("MAX_MAP_PLANES");
-
-	VectorNormalize (p->normal);
+	length = VectorNormalize (p->normal);
 
 	p->type = (p+1)->type = PlaneTypeForNormal (p->normal);
 
-	p->dist = DotProduct (origin, p->normal); 
+	// the integer dot product is the same for every point on the plane,
+	// so dist doesn't depend on which point found the plane first
+	p->dist = ((vec_t)p->inormal[0]*iorigin[0] + (vec_t)p->inormal[1]*iorigin[1]
+		+ (vec_t)p->inormal[2]*iorigin[2]) / length;
 	VectorSubtract (vec3_origin, p->normal, (p+1)->normal);
 	(p+1)->dist = -p->dist;
 
-	// allways put axial planes facing positive first
-	if (p->type < 3)
+	PlaneHashAdd (i);
+	PlaneHashAdd (i + 1);
+	nummapplanes += 2;
+
+	ThreadUnlock ();
+	return planenum;
+}
+
+/*
+=============
+SortMapPlanes
+
+Brushes are turned into planes on several threads at once, so the order
+planes are created in changes from run to run.  FindIntPlane always puts
+the same side of a pair first, so sorting the pairs on their first plane
+gives the same plane numbers for the same map on any number of threads.
+=============
+*/
+static int PlaneCompare (const void *a, const void *b)
+{
+	plane_t		*p1, *p2;
+	unsigned	d1, d2;
+	int			j;
+
+	p1 = &mapplanes[*(int *)a];
+	p2 = &mapplanes[*(int *)b];
+
+	for (j=0 ; j<3 ; j++)
+	{
+		if (p1->inormal[j] != p2->inormal[j])
+			return p1->inormal[j] < p2->inormal[j] ? -1 : 1;
+	}
+
+	d1 = PlaneDistKey (p1->inormal, p1->iorigin);
+	d2 = PlaneDistKey (p2->inormal, p2->iorigin);
+	if (d1 != d2)
+		return d1 < d2 ? -1 : 1;
+
+	return 0;
+}
+
+void SortMapPlanes (void)
+{
+	int		i, h, numpairs;
+	int		*order, *remap;
+	plane_t	*sorted;
+	brush_t	*b;
+	bface_t	*f;
+
+	numpairs = nummapplanes / 2;
+
+	order = malloc (numpairs * sizeof(*order));
+	remap = malloc (nummapplanes * sizeof(*remap));
+	sorted = malloc (nummapplanes * sizeof(*sorted));
+
+	for (i=0 ; i<numpairs ; i++)
+		order[i] = i * 2;
+	qsort (order, numpairs, sizeof(*order), PlaneCompare);
+
+	for (i=0 ; i<numpairs ; i++)
 	{
-		if (inormal[0] < 0 || inormal[1] < 0 || inormal[2] < 0)
+		sorted[i*2] = mapplanes[order[i]];
+		sorted[i*2+1] = mapplanes[order[i]+1];
+		remap[order[i]] = i*2;
+		remap[order[i]+1] = i*2+1;
+	}
+	memcpy (mapplanes, sorted, nummapplanes * sizeof(*sorted));
+
+	for (i=0, b=mapbrushes ; i<nummapbrushes ; i++, b++)
+	{
+		for (h=0 ; h<NUM_HULLS ; h++)
 		{
-			// flip order
-			temp = *p;
-			*p = *(p+1);
-			*(p+1) = temp;
-			nummapplanes += 2;
-			ThreadUnlock ();
-			return i + 1;
+			for (f=b->hulls[h].faces ; f ; f=f->next)
+			{
+				f->planenum = remap[f->planenum];
+				f->plane = &mapplanes[f->planenum];
+			}
 		}
 	}
 
-	nummapplanes += 2;
-	ThreadUnlock ();
-	return i;
+	memset ((void *)planehash, 0, sizeof(planehash));
+	for (i=0 ; i<nummapplanes ; i++)
+		PlaneHashAdd (i);
+
+	free (order);
+	free (remap);
+	free (sorted);
 }
 
 int PlaneFromPoints (int *p0, int *p1, int *p2)
@@ -648,7 +773,9 @@ void ExpandBrush (brush_t *b, int hullnum)
 				corner = - hull_size[hullnum][0][x];
 			else
 				corner = 0;
-			iorigin[x] += p->normal[x]*corner;
+			// round the offset on its own, rounding the moved point
+			// would depend on which point is stored for the plane
+			iorigin[x] += (int)(p->normal[x]*corner);
 		}
 		nf = malloc(sizeof(*nf));
 		memset (nf, 0, sizeof(*nf));
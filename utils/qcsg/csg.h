@@ -124,6 +124,7 @@ brush_t *Brush_LoadEntity (entity_t *ent, int hullnum);
 int	PlaneTypeForNormal (vec3_t normal);
 
 void CreateBrush (int brushnum);
+void SortMapPlanes (void);
 
 //=============================================================================
 
@@ -837,6 +837,7 @@ int main (int argc, char **argv)
 	LoadMapFile (name);
 
 	RunThreadsOnIndividual (nummapbrushes, true, CreateBrush);
+	SortMapPlanes ();
 
 	BoundWorld ();
 
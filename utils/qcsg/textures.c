@@ -11,6 +11,12 @@
 
 #include "csg.h"
 
+#ifdef WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#endif
+
 typedef struct
 {
 	char		identification[4];		// should be WAD2/WAD3
@@ -33,6 +39,15 @@ typedef struct
 
 } lumpinfo_t;
 
+#define	DISK_LUMPINFO_SIZE	(sizeof(lumpinfo_t) - sizeof(int))	// iTexFile is NOT in the file
+
+// a wad file, mapped or read into memory
+typedef struct
+{
+	byte		*base;
+	int			length;
+} texfile_t;
+
 int			nummiptex;
 lumpinfo_t	miptex[MAX_MAP_TEXTURES];
 
@@ -40,7 +55,7 @@ int			nTexLumps = 0;
 lumpinfo_t	*lumpinfo = NULL;
 
 int			nTexFiles = 0;
-FILE		*texfiles[128];
+texfile_t	texfiles[128];
 
 int			nWadInclude;
 char		*pszWadInclude[128];
@@ -87,6 +102,46 @@ lump_sorter_by_name( const void *lump1, const void *lump2 )
 	return strcmp( plump1->name, plump2->name );
 }
 
+/*
+=================
+TEX_MapWad
+
+Maps the wad into memory, or reads all of it when that fails.  The
+directory and the textures are copied straight out of it.
+=================
+*/
+void TEX_MapWad (FILE *f, texfile_t *tf)
+{
+#ifdef WIN32
+	HANDLE	mapping;
+#endif
+
+	tf->length = filelength (f);
+	tf->base = NULL;
+
+#ifdef WIN32
+	mapping = CreateFileMapping ((HANDLE)_get_osfhandle (fileno (f)), NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping)
+	{
+		tf->base = MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle (mapping);	// the view keeps the mapping alive
+	}
+#else
+	if (tf->length)
+	{
+		tf->base = mmap (NULL, tf->length, PROT_READ, MAP_SHARED, fileno (f), 0);
+		if (tf->base == MAP_FAILED)
+			tf->base = NULL;
+	}
+#endif
+
+	if (!tf->base)
+	{
+		tf->base = malloc (tf->length + 1);
+		SafeRead (f, tf->base, tf->length);
+	}
+}
+
 /*
 =================
 TEX_InitFromWad
@@ -98,6 +153,7 @@ qboolean	TEX_InitFromWad (char *path)
 	wadinfo_t	wadinfo;
 	char		szTmpPath[512];
 	char		*pszWadFile;
+	texfile_t	*tf;
 
 	strcpy(szTmpPath, path);
 
@@ -112,24 +168,28 @@ qboolean	TEX_InitFromWad (char *path)
 	{
 		FILE *texfile;	// temporary used in this loop
 
-		texfiles[nTexFiles] = fopen(pszWadFile, "rb");
-		if (!texfiles[nTexFiles])
+		texfile = fopen(pszWadFile, "rb");
+		if (!texfile)
 		{
 			// maybe this wad file has a hard code drive
 			if (pszWadFile[1] == ':')
 			{
 				pszWadFile += 2; // skip past the file
-				texfiles[nTexFiles] = fopen (pszWadFile, "rb");
+				texfile = fopen (pszWadFile, "rb");
 			}
 		}
 
 
-		if (!texfiles[nTexFiles])
+		if (!texfile)
 		{
 			printf ("WARNING: couldn't open %s\n", pszWadFile);
 			return false;
 		}
 
+		tf = &texfiles[nTexFiles];
+		TEX_MapWad (texfile, tf);
+		fclose (texfile);
+
 		++nTexFiles;
 
 		// look and see if we're supposed to include the textures from this WAD in the bsp.
@@ -141,25 +201,30 @@ qboolean	TEX_InitFromWad (char *path)
 			}
 		}
 
-		// temp assignment to make things cleaner:
-		texfile = texfiles[nTexFiles-1];
-
 		printf ("Using WAD File: %s\n", pszWadFile);
 
-		SafeRead(texfile, &wadinfo, sizeof(wadinfo));
+		if (tf->length < sizeof(wadinfo))
+			Error ("TEX_InitFromWad: %s isn't a wadfile",pszWadFile);
+		memcpy (&wadinfo, tf->base, sizeof(wadinfo));
 		if (strncmp (wadinfo.identification, "WAD2", 4) &&
 			strncmp (wadinfo.identification, "WAD3", 4))
 			Error ("TEX_InitFromWad: %s isn't a wadfile",pszWadFile);
 		wadinfo.numlumps = LittleLong(wadinfo.numlumps);
 		wadinfo.infotableofs = LittleLong(wadinfo.infotableofs);
-		fseek (texfile, wadinfo.infotableofs, SEEK_SET);
+
+		// check the count before multiplying, so a bad header can't overflow it
+		if (wadinfo.infotableofs < 0 || wadinfo.infotableofs > tf->length
+			|| wadinfo.numlumps < 0
+			|| wadinfo.numlumps > (tf->length - wadinfo.infotableofs) / DISK_LUMPINFO_SIZE)
+			Error ("TEX_InitFromWad: %s has a bad directory",pszWadFile);
+
 		lumpinfo = realloc(lumpinfo, (nTexLumps + wadinfo.numlumps) 
 			* sizeof(lumpinfo_t));
 
 		for(i = 0; i < wadinfo.numlumps; i++)
 		{
-			SafeRead(texfile, &lumpinfo[nTexLumps], sizeof(lumpinfo_t) - 
-				sizeof(int));	// iTexFile is NOT read from file
+			memcpy (&lumpinfo[nTexLumps], tf->base + wadinfo.infotableofs
+				+ i*DISK_LUMPINFO_SIZE, DISK_LUMPINFO_SIZE);
 			CleanupName (lumpinfo[nTexLumps].name, lumpinfo[nTexLumps].name);
 			lumpinfo[nTexLumps].filepos = LittleLong(lumpinfo[nTexLumps].filepos);
 			lumpinfo[nTexLumps].disksize = LittleLong(lumpinfo[nTexLumps].disksize);
@@ -200,10 +265,16 @@ LoadLump
 */
 int LoadLump (lumpinfo_t *source, byte *dest, int *texsize)
 {
+	texfile_t	*tf;
+
 	*texsize = 0;
 	if ( source->filepos )
 	{
-		fseek (texfiles[source->iTexFile], source->filepos, SEEK_SET);
+		tf = &texfiles[source->iTexFile];
+		if ( source->filepos < 0 || source->disksize < (int)sizeof(miptex_t)
+			|| source->filepos > tf->length - source->disksize )
+			Error ("LoadLump: texture %s is outside its wad file", source->name);
+
 		*texsize = source->disksize;
 		
 		// Should we just load the texture header w/o the palette & bitmap?
@@ -213,7 +284,7 @@ int LoadLump (lumpinfo_t *source, byte *dest, int *texsize)
 			// We will load the entire texture from the WAD at engine runtime
 			int			i;
 			miptex_t	*miptex = (miptex_t *)dest;
-			SafeRead (texfiles[source->iTexFile], dest, sizeof(miptex_t) );
+			memcpy (dest, tf->base + source->filepos, sizeof(miptex_t) );
 			for( i=0; i<MIPLEVELS; i++ )
 				miptex->offsets[i] = 0;
 			return sizeof(miptex_t);
@@ -221,7 +292,7 @@ int LoadLump (lumpinfo_t *source, byte *dest, int *texsize)
 		else
 		{
 			// Load the entire texture here so the BSP contains the texture
-			SafeRead (texfiles[source->iTexFile], dest, source->disksize );
+			memcpy (dest, tf->base + source->filepos, source->disksize );
 			return source->disksize;
 		}
 	}
@@ -231,6 +302,93 @@ int LoadLump (lumpinfo_t *source, byte *dest, int *texsize)
 }
 
 
+/*
+=============
+MiptexHash
+
+Texture names are hashed without case, like they are compared.  As with
+the plane hash, lookups run without the lock and a name is published in
+miptexhash only after it has been copied in, through the same interlocked
+calls.
+=============
+*/
+#define	MIPTEX_HASHES	1024
+
+static LONG	volatile miptexhash[MIPTEX_HASHES];	// miptex number + 1, 0 ends a chain
+static int	miptexchain[MAX_MAP_TEXTURES];
+
+static unsigned MiptexHash (char *name)
+{
+	unsigned	hash;
+
+	hash = 2166136261u;
+	while (*name)
+	{
+		hash ^= (unsigned char)tolower (*name++);
+		hash *= 16777619;
+	}
+
+	return hash % MIPTEX_HASHES;
+}
+
+static int MiptexHashFind (char *name, unsigned hash)
+{
+	int		i;
+
+	for (i = InterlockedExchangeAdd (&miptexhash[hash], 0) - 1 ; i >= 0 ; i = miptexchain[i] - 1)
+		if (!Q_strcasecmp (name, miptex[i].name))
+			return i;
+
+	return -1;
+}
+
+static void MiptexHashAdd (int i)
+{
+	unsigned	hash;
+
+	hash = MiptexHash (miptex[i].name);
+	miptexchain[i] = miptexhash[hash];
+	InterlockedExchange (&miptexhash[hash], i + 1);
+}
+
+// miptex has been reordered, chains are rebuilt with the lowest number first
+static void RehashMiptex (void)
+{
+	int		i;
+
+	memset ((void *)miptexhash, 0, sizeof(miptexhash));
+	for (i=nummiptex-1 ; i>=0 ; i--)
+		MiptexHashAdd (i);
+}
+
+int	FindMiptex (char *name)
+{
+	int		i;
+	unsigned	hash;
+
+	hash = MiptexHash (name);
+
+	i = MiptexHashFind (name, hash);
+	if (i != -1)
+		return i;
+
+	ThreadLock ();
+	i = MiptexHashFind (name, hash);
+	if (i != -1)
+	{
+		ThreadUnlock ();
+		return i;
+	}
+	if (nummiptex == MAX_MAP_TEXTURES)
+		Error ("Exceeded MAX_MAP_TEXTURES");
+	i = nummiptex;
+	strcpy (miptex[i].name, name);
+	MiptexHashAdd (i);
+	nummiptex++;
+	ThreadUnlock ();
+	return i;
+}
+
 /*
 ==================
 AddAnimatingTextures
@@ -331,6 +489,7 @@ void WriteMiptex(void)
 
 		// Sort them FIRST by wadfile and THEN by name for most efficient loading in the engine.
 		qsort( (void *)miptex, (size_t)nummiptex, sizeof(miptex[0]), lump_sorter_by_wad_and_name );
+		RehashMiptex ();
 
 		// Sleazy Hack 104 Pt 2 - After sorting the miptex array, reset the texinfos to point to the right miptexs
 		for(i=0; i<numtexinfo; i++, tx++)
@@ -374,25 +533,6 @@ void WriteMiptex(void)
 //==========================================================================
 
 
-int	FindMiptex (char *name)
-{
-	int		i;
-
-	ThreadLock ();
-	for (i=0 ; i<nummiptex ; i++)
-		if (!Q_strcasecmp (name, miptex[i].name))
-		{
-			ThreadUnlock ();
-			return i;
-		}
-	if (nummiptex == MAX_MAP_TEXTURES)
-		Error ("Exceeded MAX_MAP_TEXTURES");
-	strcpy (miptex[i].name, name);
-	nummiptex++;
-	ThreadUnlock ();
-	return i;
-}
-
 int TexinfoForBrushTexture (plane_t *plane, brush_texture_t *bt, vec3_t origin)
 {
 	vec3_t	vecs[2];
@@ -51,41 +51,160 @@ s_trianglevert_t (*triangles)[3];
 s_mesh_t *pmesh;
 
 
+/*
+================
+Edge hash
+
+Every directed edge of the mesh is hashed on its two vertexes, and edges
+with the same vertexes are kept in one group in triangle order.  A group
+is looked up with the edge a triangle needs its neighbor to have, and the
+first triangle in the group that FindNeighbor would have reached scanning
+the mesh is the same neighbor the scan found.
+================
+*/
+#define	EDGE_HASHES		8192
+
+typedef struct
+{
+	int		tri, v;		// edge from triangles[tri][v] to triangles[tri][(v+1)%3]
+	int		next;		// next edge in the group, -1 ends it
+} s_edge_t;
+
+typedef struct
+{
+	int		first;		// first edge that can still be a neighbor
+	int		last;
+	int		next;		// next group in the hash chain, -1 ends it
+} s_edgegroup_t;
+
+s_edge_t		edges[MAXSTUDIOTRIANGLES*3];
+s_edgegroup_t	edgegroups[MAXSTUDIOTRIANGLES*3];
+int				numedgegroups;
+int				edgehash[EDGE_HASHES];
+
+
+unsigned EdgeHash (s_trianglevert_t *v1, s_trianglevert_t *v2)
+{
+	unsigned		hash;
+	unsigned char	*b;
+	int				i;
+
+	// same bytes memcmp compares
+	hash = 2166136261u;
+	for (i = 0, b = (unsigned char *)v1; i < sizeof(*v1); i++)
+		hash = (hash ^ b[i]) * 16777619;
+	for (i = 0, b = (unsigned char *)v2; i < sizeof(*v2); i++)
+		hash = (hash ^ b[i]) * 16777619;
+
+	return hash % EDGE_HASHES;
+}
+
+
+int FindEdgeGroup (s_trianglevert_t *v1, s_trianglevert_t *v2)
+{
+	int		g;
+	s_edge_t	*e;
+
+	for (g = edgehash[EdgeHash( v1, v2 )]; g != -1; g = edgegroups[g].next)
+	{
+		e = &edges[edgegroups[g].first];
+		if (memcmp( &triangles[e->tri][e->v], v1, sizeof(*v1) ))
+			continue;
+		if (memcmp( &triangles[e->tri][(e->v+1)%3], v2, sizeof(*v2) ))
+			continue;
+		return g;
+	}
+	return -1;
+}
+
+
+void BuildEdgeGroups (void)
+{
+	int		i, k, g;
+	unsigned	hash;
+	s_edge_t	*e;
+
+	numedgegroups = 0;
+	for (i = 0; i < EDGE_HASHES; i++)
+		edgehash[i] = -1;
+
+	for (i = 0; i < pmesh->numtris; i++)
+	{
+		for (k = 0; k < 3; k++)
+		{
+			e = &edges[i*3+k];
+			e->tri = i;
+			e->v = k;
+			e->next = -1;
+
+			g = FindEdgeGroup( &triangles[i][k], &triangles[i][(k+1)%3] );
+			if (g == -1)
+			{
+				hash = EdgeHash( &triangles[i][k], &triangles[i][(k+1)%3] );
+				g = numedgegroups++;
+				edgegroups[g].first = i*3+k;
+				edgegroups[g].next = edgehash[hash];
+				edgehash[hash] = g;
+			}
+			else
+			{
+				edges[edgegroups[g].last].next = i*3+k;
+			}
+			edgegroups[g].last = i*3+k;
+		}
+	}
+}
+
+
 void	FindNeighbor (int starttri, int startv)
 {
-	s_trianglevert_t			m1, m2;
-	int			j;
-	s_trianglevert_t	*last, *check;
-	int			k;
+	s_trianglevert_t	*last;
+	s_edgegroup_t		*group;
+	s_edge_t			*e;
+	int					g, n;
+	int					j, k;
 
 	// used[starttri] |= (1 << startv);
 
 	last = &triangles[starttri][0];
 
-	m1 = last[(startv+1)%3];
-	m2 = last[(startv+0)%3];
+	// neighbor has the same edge going the other way
+	g = FindEdgeGroup( &last[(startv+1)%3], &last[(startv+0)%3] );
+	if (g == -1)
+		return;
+	group = &edgegroups[g];
+
+	// starttri only goes up, so edges on earlier triangles and triangles
+	// that are fully joined can be dropped from the front for good
+	n = group->first;
+	while (n != -1 && (edges[n].tri <= starttri || used[edges[n].tri] == 7))
+		n = edges[n].next;
+	if (n == -1)
+	{
+		// keep one edge for FindEdgeGroup to compare against
+		group->first = group->last;
+		return;
+	}
+	group->first = n;
 
-	for (j=starttri+1, check=&triangles[starttri+1][0] ; j<pmesh->numtris ; j++, check += 3)
+	for ( ; n != -1; n = e->next)
 	{
+		e = &edges[n];
+		j = e->tri;
+		k = e->v;
+
 		if (used[j] == 7)
 			continue;
-		for (k=0 ; k<3 ; k++)
-		{
-			if (memcmp(&check[k],&m1,sizeof(m1)))
-				continue;
-			if (memcmp(&check[ (k+1)%3 ],&m2,sizeof(m2)))
-				continue;
 
-			neighbortri[starttri][startv] = j;
-			neighboredge[starttri][startv] = k;
+		neighbortri[starttri][startv] = j;
+		neighboredge[starttri][startv] = k;
 
-			neighbortri[j][k] = starttri;
-			neighboredge[j][k] = startv;
+		neighbortri[j][k] = starttri;
+		neighboredge[j][k] = startv;
 
-			used[starttri] |= (1 << startv);
-			used[j] |= (1 << k);
-			return;
-		}
+		used[starttri] |= (1 << startv);
+		used[j] |= (1 << k);
+		return;
 	}
 }
 
@@ -138,10 +257,9 @@ int	StripLength (int starttri, int startv)
 
 done:
 
-	// clear the temp used flags
-	for (j=0 ; j<pmesh->numtris ; j++)
-		if (used[j] == 2)
-			used[j] = 0;
+	// clear the temp used flags, only the tris on the strip were set
+	for (j=0 ; j<stripcount ; j++)
+		used[striptris[j]] = 0;
 
 	return stripcount;
 }
@@ -187,10 +305,9 @@ int	FanLength (int starttri, int startv)
 
 done:
 
-	// clear the temp used flags
-	for (j=0 ; j<pmesh->numtris ; j++)
-		if (used[j] == 2)
-			used[j] = 0;
+	// clear the temp used flags, only the tris on the strip were set
+	for (j=0 ; j<stripcount ; j++)
+		used[striptris[j]] = 0;
 
 	return stripcount;
 }
@@ -233,6 +350,7 @@ int BuildTris (s_trianglevert_t (*x)[3], s_mesh_t *y, byte **ppdata )
 	}
 
 	// printf("finding neighbors\n");
+	BuildEdgeGroups ();
 	for (i=0 ; i<pmesh->numtris; i++)
 	{
 		for (k = 0; k < 3; k++)
@@ -10,6 +10,8 @@
 
 #include "vis.h"
 
+#include <emmintrin.h>
+
 int		c_fullskip;
 int		c_chains;
 int		c_portalskip, c_leafskip;
@@ -390,6 +392,30 @@ winding_t	*ClipToSeperators (winding_t *source, winding_t *pass, winding_t *targ
 
 
 
+/*
+==================
+MergeMightsee
+
+dest = might & test, 16 bytes at a time (bitbytes is padded to that).
+Returns true if dest has a leaf that vis doesn't have yet.
+==================
+*/
+qboolean MergeMightsee (byte *dest, byte *might, byte *test, byte *vis)
+{
+	__m128i	d, more;
+	int		i;
+
+	more = _mm_setzero_si128 ();
+	for (i=0 ; i<bitbytes ; i+=16)
+	{
+		d = _mm_and_si128 (_mm_loadu_si128 ((__m128i *)(might+i)), _mm_loadu_si128 ((__m128i *)(test+i)));
+		_mm_storeu_si128 ((__m128i *)(dest+i), d);
+		more = _mm_or_si128 (more, _mm_andnot_si128 (_mm_loadu_si128 ((__m128i *)(vis+i)), d));
+	}
+
+	return _mm_movemask_epi8 (_mm_cmpeq_epi8 (more, _mm_setzero_si128 ())) != 0xffff;
+}
+
 /*
 ==================
 RecursiveLeafFlow
@@ -404,8 +430,8 @@ void RecursiveLeafFlow (int leafnum, threaddata_t *thread, pstack_t *prevstack)
 	portal_t	*p;
 	plane_t		backplane;
 	leaf_t 		*leaf;
-	int			i, j;
-	long		*test, *might, *vis, more;
+	int			i;
+	byte		*test;
 	int			pnum;
 
 	c_chains++;
@@ -426,9 +452,6 @@ void RecursiveLeafFlow (int leafnum, threaddata_t *thread, pstack_t *prevstack)
 	stack.leaf = leaf;
 	stack.portal = NULL;
 
-	might = (long *)stack.mightsee;
-	vis = (long *)thread->leafvis;
-	
 // check all portals for flowing into other leafs	
 	for (i=0 ; i<leaf->numportals ; i++)
 	{
@@ -451,22 +474,15 @@ void RecursiveLeafFlow (int leafnum, threaddata_t *thread, pstack_t *prevstack)
 		if (p->status == stat_done)
 		{
 			c_vistest++;
-			test = (long *)p->visbits;
+			test = p->visbits;
 		}
 		else
 		{
 			c_mighttest++;
-			test = (long *)p->mightsee;
+			test = p->mightsee;
 		}
 
-		more = 0;
-		for (j=0 ; j<bitlongs ; j++)
-		{
-			might[j] = ((long *)prevstack->mightsee)[j] & test[j];
-			more |= (might[j] & ~vis[j]);
-		}
-		
-		if (!more)
+		if (!MergeMightsee (stack.mightsee, prevstack->mightsee, test, thread->leafvis))
 		{	// can't see anything new
 			c_portalskip++;
 			continue;
@@ -531,8 +547,7 @@ void RecursiveLeafFlow (int leafnum, threaddata_t *thread, pstack_t *prevstack)
 			thread->fullportal[pnum>>3] |= (1<<(pnum&7));
 			FreeStackWinding (stack.source, &stack);
 			stack.source = ChopWinding (thread->base->winding, &stack, &backplane);
-			for (j=0 ; j<bitlongs ; j++)
-				might[j] = ((long *)thread->pstack_head.mightsee)[j] & test[j];
+			MergeMightsee (stack.mightsee, thread->pstack_head.mightsee, test, thread->leafvis);
 		}
 #endif
 	// flow through it for real
@@ -550,7 +565,6 @@ PortalFlow
 void PortalFlow (portal_t *p)
 {
 	threaddata_t	data;
-	int				i;
 
 	if (p->status != stat_working)
 		Error ("PortalFlow: reflowed");
@@ -566,8 +580,7 @@ void PortalFlow (portal_t *p)
 	data.pstack_head.portal = p;
 	data.pstack_head.source = p->winding;
 	data.pstack_head.portalplane = p->plane;
-	for (i=0 ; i<bitlongs ; i++)
-		((long *)data.pstack_head.mightsee)[i] = ((long *)p->mightsee)[i];
+	memcpy (data.pstack_head.mightsee, p->mightsee, bitbytes);
 	RecursiveLeafFlow (p->leaf, &data, &data.pstack_head);
 
 	p->status = stat_done;
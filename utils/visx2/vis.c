@@ -33,8 +33,7 @@ int		originalvismapsize;
 
 byte	*uncompressed;			// [bitbytes*portalleafs]
 
-int		bitbytes;				// (portalleafs+63)>>3
-int		bitlongs;
+int		bitbytes;				// portalleafs rounded up to 128 bits, in bytes
 
 qboolean		fastvis;
 qboolean		verbose;
@@ -100,44 +99,63 @@ void prl(leaf_t *l)
 
 //=============================================================================
 
+/*
+=============
+SortPortals
+
+Portals are handed out from the least complex, so the later ones can
+reuse the earlier information.  nummightsee doesn't change while the
+portals flow, so the order is worked out once up front instead of
+searching all the portals for each one handed out.
+=============
+*/
+portal_t	**sortedportals;
+
+int PortalCompare (const void *a, const void *b)
+{
+	portal_t	*p1, *p2;
+
+	p1 = *(portal_t **)a;
+	p2 = *(portal_t **)b;
+
+	if (p1->nummightsee != p2->nummightsee)
+		return p1->nummightsee - p2->nummightsee;
+
+	// same order the search used to break ties in
+	return p1 - p2;
+}
+
+void SortPortals (void)
+{
+	int		i;
+
+	sortedportals = malloc (numportals*2*sizeof(*sortedportals));
+	for (i=0 ; i<numportals*2 ; i++)
+		sortedportals[i] = &portals[i];
+
+	qsort (sortedportals, numportals*2, sizeof(*sortedportals), PortalCompare);
+}
+
 /*
 =============
 GetNextPortal
 
 Returns the next portal for a thread to work on
-Returns the portals from the least complex, so the later ones can reuse
-the earlier information.
 =============
 */
 portal_t *GetNextPortal (void)
 {
-	int		j;
-	portal_t	*p, *tp;
-	int		min;
 	int		i;
+	portal_t	*p;
 
 	i = GetThreadWork ();	// bump the pacifier
 	if (i == -1)
 		return NULL;
 
-	ThreadLock();
-
-	min = 99999;
-	p = NULL;
-	
-	for (j=0, tp = portals ; j<numportals*2 ; j++, tp++)
-	{
-		if (tp->nummightsee < min && tp->status == stat_none)
-		{
-			min = tp->nummightsee;
-			p = tp;
-		}
-	}
-
-	if (p)
-		p->status = stat_working;
-
-	ThreadUnlock();
+	p = sortedportals[i];
+	if (p->status != stat_none)
+		Error ("GetNextPortal: portal %i handed out twice", (int)(p - portals));
+	p->status = stat_working;
 
 	return p;
 }
@@ -289,7 +307,9 @@ void CalcPortalVis (void)
 	
 	leafon = 0;
 	
+	SortPortals ();
 	RunThreadsOn (numportals*2, true, LeafThread);
+	free (sortedportals);
 
 	qprintf ("portalcheck: %i  portaltest: %i  portalpass: %i\n",c_portalcheck, c_portaltest, c_portalpass);
 	qprintf ("c_vistest: %i  c_mighttest: %i\n",c_vistest, c_mighttest);
@@ -357,8 +377,7 @@ void LoadPortals (char *name)
 	printf ("%4i portalleafs\n", portalleafs);
 	printf ("%4i numportals\n", numportals);
 
-	bitbytes = ((portalleafs+63)&~63)>>3;
-	bitlongs = bitbytes/sizeof(long);
+	bitbytes = ((portalleafs+127)&~127)>>3;
 	
 // each file portal is split into two memory portals
 	portals = malloc(2*numportals*sizeof(portal_t));
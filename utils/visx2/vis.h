@@ -130,7 +130,6 @@ extern	qboolean		showgetleaf;
 
 extern	byte		*uncompressed;
 extern	int			bitbytes;
-extern	int			bitlongs;
 
 
 void LeafFlow (int leafnum);